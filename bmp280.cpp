@@ -1,4 +1,3 @@
-```
 /*
  * bmp280.cpp
  *
@@ -26,7 +25,6 @@
  *    that are available on their GitHub site.
  */
 
-#include <ctime>             // time_t, time()
 #include <mutex>             // mutex, lock_guard
 #include <stdexcept>         // runtime_error
 #include <unistd.h>          // usleep()
@@ -42,15 +40,20 @@ namespace bosch_bmp280
 // -----------------------------------------------------------------
 
 /*
- * BMP280::BMP280(I2CBus* bus, uint8_t addr)
+ * BMP280::BMP280(BMP280Bus* devbus, uint8_t addr)
  *
  * Description:
- *   Constructor. Assigns the I2C bus and the target device address.
+ *   Constructor. Assigns the bus and the target device address.
  *   Initializes temperature compensation variable tfine to zero.
  *
+ *   The ctrl_meas/config shadows start out invalid, since the device
+ *   may have been configured by someone else. They are loaded from
+ *   the device the first time they are needed.
+ *
  * Parameters:
- *   bus  - pointer to an I2CBus object
- *   addr - I2C address of the target device
+ *   devbus - pointer to the bus the device is on: a BMP280I2CBus,
+ *            a BMP280SimBus, or any other BMP280Bus. Not owned.
+ *   addr   - address of the target device on that bus
  *
  * Namespace:
  *   bosch_bmp280
@@ -58,12 +61,45 @@ namespace bosch_bmp280
  * Header File(s):
  *   bmp280.hpp
  */
-BMP280::BMP280(bbbi2c::I2CBus* bus, uint8_t addr)
+BMP280::BMP280(BMP280Bus* devbus, uint8_t addr)
 {
-    i2cbus  = bus;
+    bus     = devbus;
     i2caddr = addr;
     tfine   = 0;
+
+    ctrlshadow  = 0;
+    confshadow  = 0;
+    shadowvalid = false;
+
+    for (int i = 0; i < BMP280_CAL_SIZE; i++)
+        calraw[i] = 0;
+}
+
+#if BMP280_BBBI2C
+/*
+ * BMP280::BMP280(I2CBus* i2cbus, uint8_t addr)
+ *
+ * Description:
+ *   Constructor, for a device on a BeagleBone Black I2C bus. Wraps
+ *   the I2CBus in a BMP280I2CBus of its own; Bus()->Port() is the
+ *   I2CBus, so devices made this way on one I2CBus share a bus.
+ *
+ * Parameters:
+ *   i2cbus - pointer to an I2CBus object. Not owned.
+ *   addr   - I2C address of the target device
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280.hpp
+ */
+BMP280::BMP280(bbbi2c::I2CBus* i2cbus, uint8_t addr)
+    : BMP280(new BMP280I2CBus(i2cbus), addr)
+{
+    ownbus.reset(bus);
 }
+#endif
 
 /*
  * BMP280::~BMP280()
@@ -103,7 +139,9 @@ BMP280::~BMP280()
  */
 void BMP280::GetRegs(uint8_t startaddr, uint8_t* data, int len)
 {
-    i2cbus->Xfer(&startaddr, 1, data, len, i2caddr);
+    BMP280_METRIC_SCOPE(metrics, BMP280Op::Read, len + 1);
+    bus->Read(i2caddr, startaddr, data, len);
+    BMP280_METRIC_DONE();
 }
 
 /*
@@ -130,18 +168,58 @@ void BMP280::GetRegs(uint8_t startaddr, uint8_t* data, int len)
  */
 void BMP280::SetRegs(uint8_t* data, int len)
 {
-    i2cbus->Write(data, len, i2caddr);
+    BMP280_METRIC_SCOPE(metrics, BMP280Op::Write, len);
+    bus->Write(i2caddr, data, len);
+    BMP280_METRIC_DONE();
 }
 
 
-// BMP280 Public
-// -----------------------------------------------------------------
+/*
+ * void BMP280::DecodeUncomp(const uint8_t* dat, TP32Data& unc)
+ *
+ * Description:
+ *   Unpacks the six data registers (0xF7..0xFC) into raw 20-bit
+ *   temperature and pressure values. The time stamp is not touched.
+ *
+ * Parameters:
+ *   dat - six bytes read from BMP280_R_PMSB onward
+ *   unc - receives the uncompensated temperature and pressure
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::DecodeUncomp(const uint8_t* dat, TP32Data& unc)
+{
+    unc.pressure =
+        (int32_t) (
+            (((uint32_t)dat[0]) << 12) |
+            (((uint32_t)dat[1]) <<  4) |
+            (((uint32_t)dat[2]) >>  4)
+            );
+
+    unc.temperature =
+        (int32_t) (
+            (((int32_t)dat[3]) << 12) |
+            (((int32_t)dat[4]) <<  4) |
+            (((int32_t)dat[5]) >>  4)
+            );
+}
 
 /*
- * void BMP280::LoadCalParams()
+ * void BMP280::Compensate(TP32Data& reading)
  *
  * Description:
- *   Loads calibration parameters from the device ROM.
+ *   Applies 32-bit fixed-point compensation to an uncompensated
+ *   reading, in place, using the compiled calibration parameters.
+ *   Loads the calibration parameters first if necessary, and leaves
+ *   tfine set as Comp32FixedTemp() would.
+ *
+ * Parameters:
+ *   reading - in: raw temperature and pressure.
+ *             out: compensated temperature and pressure.
  *
  * Namespace:
  *   bosch_bmp280
@@ -149,11 +227,30 @@ void BMP280::SetRegs(uint8_t* data, int len)
  * Header File(s);
  *   bmp280.hpp
  */
-void BMP280::LoadCalParams()
+void BMP280::Compensate(TP32Data& reading)
 {
-	uint8_t dat[BMP280_CAL_SIZE] {0};
+    if (!cparams.loaded) this->LoadCalParams();
 
-	this->GetRegs(BMP280_CAL_START, dat, BMP280_CAL_SIZE);
+    reading.temperature = ccal.Temp(reading.temperature, tfine);
+    reading.pressure    = ccal.Press(reading.pressure, tfine);
+}
+
+/*
+ * void BMP280::DecodeCalParams()
+ *
+ * Description:
+ *   Unpacks the raw calibration bytes in calraw into cparams, and
+ *   compiles them for compensation.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::DecodeCalParams()
+{
+	const uint8_t* dat = calraw;
 
 	cparams.t1 = ((uint16_t)dat[BMP280_CAL_T1H_NDX] << 8) | (uint16_t)dat[BMP280_CAL_T1L_NDX];
 	cparams.t2 = (( int16_t)dat[BMP280_CAL_T2H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_T2L_NDX];
@@ -170,6 +267,136 @@ void BMP280::LoadCalParams()
 	cparams.p9 = (( int16_t)dat[BMP280_CAL_P9H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_P9L_NDX];
 
 	cparams.loaded = true;
+	ccal = Cal32Fixed(cparams);
+}
+
+
+// BMP280 Public
+// -----------------------------------------------------------------
+
+/*
+ * void BMP280::LoadCalParams()
+ *
+ * Description:
+ *   Loads calibration parameters from the device ROM.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::LoadCalParams()
+{
+	this->GetRegs(BMP280_CAL_START, calraw, BMP280_CAL_SIZE);
+	this->DecodeCalParams();
+}
+
+/*
+ * void BMP280::GetCalRaw(uint8_t* dat)
+ *
+ * Description:
+ *   Copies out the calibration ROM contents, loading them from the
+ *   device first if necessary. For saving to a calibration cache.
+ *
+ * Parameters:
+ *   dat - receives BMP280_CAL_SIZE bytes
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::GetCalRaw(uint8_t* dat)
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    for (int i = 0; i < BMP280_CAL_SIZE; i++)
+        dat[i] = calraw[i];
+}
+
+/*
+ * void BMP280::SetCalRaw(const uint8_t* dat)
+ *
+ * Description:
+ *   Installs calibration ROM contents obtained elsewhere (a
+ *   calibration cache, say), in place of reading them from the
+ *   device. No bus transfer takes place.
+ *
+ * Parameters:
+ *   dat - BMP280_CAL_SIZE bytes, as read from BMP280_CAL_START
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::SetCalRaw(const uint8_t* dat)
+{
+    for (int i = 0; i < BMP280_CAL_SIZE; i++)
+        calraw[i] = dat[i];
+
+    this->DecodeCalParams();
+}
+
+/*
+ * bool BMP280::VerifyCalParams()
+ *
+ * Description:
+ *   Reads the calibration ROM again and compares it with the
+ *   parameters in use. Parameters that have not been loaded yet are
+ *   simply loaded.
+ *
+ * Returns:
+ *   Returns true if the parameters in use match the device.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+bool BMP280::VerifyCalParams()
+{
+    if (!cparams.loaded)
+    {
+        this->LoadCalParams();
+        return true;
+    }
+
+    uint8_t dat[BMP280_CAL_SIZE] {0};
+    this->GetRegs(BMP280_CAL_START, dat, BMP280_CAL_SIZE);
+
+    for (int i = 0; i < BMP280_CAL_SIZE; i++)
+        if (dat[i] != calraw[i])
+            return false;
+
+    return true;
+}
+
+/*
+ * uint8_t BMP280::GetChipId()
+ *
+ * Description:
+ *   Reads the id register.
+ *
+ * Returns:
+ *   Returns the chip id. BMP280_ID (0x58) for a BMP280.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+uint8_t BMP280::GetChipId()
+{
+    uint8_t id = 0;
+    this->GetRegs(BMP280_R_ID, &id, 1);
+
+    return id;
 }
 
 /*
@@ -194,20 +421,8 @@ TP32Data BMP280::GetUncompData()
     uint8_t dat[6]{0};
 
     this->GetRegs(BMP280_R_PMSB, dat, 6);
-
-    unc.pressure =
-        (int32_t) (
-            (((uint32_t)dat[0]) << 12) |
-            (((uint32_t)dat[1]) <<  4) |
-            (((uint32_t)dat[2]) >>  4)
-            );
-
-    unc.temperature =
-        (int32_t) (
-            (((int32_t)dat[3]) << 12) |
-            (((int32_t)dat[4]) <<  4) |
-            (((int32_t)dat[5]) >>  4)
-            );
+    unc.Stamp();
+    this->DecodeUncomp(dat, unc);
 
     return unc;
 }
@@ -236,25 +451,34 @@ TP32Data BMP280::GetUncompData()
  */
 TP32Data BMP280::GetComp32FixedData()
 {
-    TP32Data reading;
     TP32Data unc = this->GetUncompData();
 
-    reading.timestamp   = unc.timestamp;
-    reading.temperature = this->Comp32FixedTemp(unc.temperature);
-    reading.pressure    = this->Comp32FixedPress(unc.pressure);
+    BMP280_METRIC_SCOPE(metrics, BMP280Op::Comp, 0);
+    this->Compensate(unc);
+    BMP280_METRIC_DONE();
 
-    return reading;
+    return unc;
 }
 
 /*
- * void BMP280::GetConfig(uint8_t& ctrl, uint8_t& conf)
+ * int BMP280::GetUncompData(TP32Data* buf, int count, unsigned int interval)
  *
  * Description:
- *   Reads the device ctrl_meas and config registers.
+ *   Retrieves a batch of raw temperature and pressure readings into a
+ *   caller-provided buffer.
+ *
+ *   One six-byte register buffer is reused for every read. Each
+ *   reading is stamped as it is taken, so back-to-back readings
+ *   (interval = 0) are still ordered by monotime.
  *
  * Parameters:
- *   ctrl - receives the contents of the ctrl_meas register.
- *   conf - receives the contents of the config register.
+ *   buf      - receives count readings
+ *   count    - the number of readings to take
+ *   interval - optional. Microseconds to wait between readings.
+ *              The default is zero.
+ *
+ * Returns:
+ *   Returns the number of readings stored in buf.
  *
  * Namespace:
  *   bosch_bmp280
@@ -262,34 +486,42 @@ TP32Data BMP280::GetComp32FixedData()
  * Header File(s);
  *   bmp280.hpp
  */
-void BMP280::GetConfig(uint8_t& ctrl, uint8_t& conf)
+int BMP280::GetUncompData(TP32Data* buf, int count, unsigned int interval)
 {
-    uint8_t dat[2];
-    this->GetRegs(BMP280_R_CTRL, dat, 2);
+    uint8_t dat[6]{0};
+
+    for (int i = 0; i < count; i++)
+    {
+        if (i > 0 && interval > 0)
+            usleep(interval);
+
+        this->GetRegs(BMP280_R_PMSB, dat, 6);
+        buf[i].Stamp();
+        this->DecodeUncomp(dat, buf[i]);
+    }
 
-    ctrl = dat[0];
-    conf = dat[1];
+    return count;
 }
 
 /*
- * void BMP280::SetConfig(uint8_t ctrl, uint8_t conf)
+ * int BMP280::GetComp32FixedData(TP32Data* buf, int count, unsigned int interval)
  *
  * Description:
- *   Resets the BMP280 to get it into Sleep mode, then writes the
- *   ctrl and conf parameters to the ctrl_meas and config registers.
- *
- *   Note that the first write to ctrl_meas is done with the mode bits
- *   masked out (ctrx). The config register is written next, followed
- *   by the ctrl_meas register, this time with the mode bits included.
+ *   Retrieves a batch of temperature and pressure readings and applies
+ *   32-bit fixed-point compensation to all of them.
  *
- *   The CONFIG_DELAY constant is currently a number that I pulled out
- *   of a hat as a reasonable amount of time before the first data
- *   read should be attempted. The BMP280 datasheet gives the precise
- *   method of determining what this time should be.
+ *   All raw readings are taken first, then the batch is compensated
+ *   in place in one tight loop, so bus traffic and arithmetic are not
+ *   interleaved.
  *
  * Parameters:
- *   ctrl - 8-bits to be written to the ctrl_meas register.
- *   conf - 8-bits to be written to the config register.
+ *   buf      - receives count compensated readings
+ *   count    - the number of readings to take
+ *   interval - optional. Microseconds to wait between readings.
+ *              The default is zero.
+ *
+ * Returns:
+ *   Returns the number of readings stored in buf.
  *
  * Namespace:
  *   bosch_bmp280
@@ -297,24 +529,37 @@ void BMP280::GetConfig(uint8_t& ctrl, uint8_t& conf)
  * Header File(s);
  *   bmp280.hpp
  */
-void BMP280::SetConfig(uint8_t ctrl, uint8_t conf)
+int BMP280::GetComp32FixedData(TP32Data* buf, int count, unsigned int interval)
 {
-    uint8_t ctrx = (ctrl & BMP280_MODE_MSK_OUT);
-    uint8_t dat[] { BMP280_R_CTRL, ctrx, BMP280_R_CONF, conf, BMP280_R_CTRL, ctrl };
+    this->GetUncompData(buf, count, interval);
 
-    this->Reset();
-    this->SetRegs(dat, 6);
-    usleep(BMP280_CONFIG_DELAY);
+    BMP280_METRIC_SCOPE(metrics, BMP280Op::CompBatch, 0);
+    for (int i = 0; i < count; i++)
+        this->Compensate(buf[i]);
+    BMP280_METRIC_DONE();
+
+    return count;
 }
 
 /*
- * void BMP280::SetConfig(int preset)
+ * int BMP280::GetComp32FixedData(TP32DataQueue& queue, int count, unsigned int interval)
  *
  * Description:
- *   Sets the device to one of the six available preset configurations.
+ *   Retrieves a batch of compensated temperature and pressure readings
+ *   and pushes them to the back of a TP32DataQueue.
+ *
+ *   Readings are taken BMP280_BATCH_CHUNK at a time into a buffer
+ *   that belongs to the BMP280 object, so nothing is constructed or
+ *   allocated per call.
  *
  * Parameters:
- *   preset - An integer value between one and six, inclusive
+ *   queue    - receives count compensated readings
+ *   count    - the number of readings to take
+ *   interval - optional. Microseconds to wait between readings.
+ *              The default is zero.
+ *
+ * Returns:
+ *   Returns the number of readings pushed to the queue.
  *
  * Namespace:
  *   bosch_bmp280
@@ -322,94 +567,663 @@ void BMP280::SetConfig(uint8_t ctrl, uint8_t conf)
  * Header File(s);
  *   bmp280.hpp
  */
-void BMP280::SetConfig(int preset)
+int BMP280::GetComp32FixedData(TP32DataQueue& queue, int count, unsigned int interval)
 {
-    uint8_t ctrl;
-    uint8_t conf;
+    int done = 0;
 
-    switch (preset)
+    while (done < count)
     {
-      case 1:
-        ctrl = BMP280_CTRL_PRE1;
-        conf = BMP280_CONF_PRE1;
-        break;
-      case 2:
-        ctrl = BMP280_CTRL_PRE2;
-        conf = BMP280_CONF_PRE2;
-        break;
-      case 3:
-        ctrl = BMP280_CTRL_PRE3;
-        conf = BMP280_CONF_PRE3;
-        break;
-      case 4:
-        ctrl = BMP280_CTRL_PRE4;
-        conf = BMP280_CONF_PRE4;
-        break;
-      case 5:
-        ctrl = BMP280_CTRL_PRE5;
-        conf = BMP280_CONF_PRE5;
-        break;
-      case 6:
-        ctrl = BMP280_CTRL_PRE6;
-        conf = BMP280_CONF_PRE6;
-        break;
-      default:
-        ctrl = BMP280_CTRL_PRE1;
-        conf = BMP280_CONF_PRE1;
-        break;
+        int n = count - done;
+        if (n > BMP280_BATCH_CHUNK)
+            n = BMP280_BATCH_CHUNK;
+
+        if (done > 0 && interval > 0)
+            usleep(interval);
+
+        this->GetComp32FixedData(batch, n, interval);
+        for (int i = 0; i < n; i++)
+            queue.push(batch[i]);
+
+        done += n;
     }
 
-    this->SetConfig(ctrl, conf);
+    return done;
 }
 
 /*
- * void BMP280::Force()
+ * void BMP280::GetConfig(uint8_t& ctrl, uint8_t& conf)
  *
  * Description:
- *   Sets the ctrl_meas register mode bits to forced.
+ *   Retrieves the ctrl_meas and config register values.
  *
- * Initial Conditions:
- *   All other configuration settings must be completed before
- *   calling this function.
+ *   Values come from the driver's shadow copies, which track every
+ *   write made by this class, so normally no bus transaction is
+ *   needed. The registers are only read if the shadows are not valid
+ *   (see Resync()).
  *
- *   The sensor must be in sleep mode.
+ * Parameters:
+ *   ctrl - receives the contents of the ctrl_meas register.
+ *   conf - receives the contents of the config register.
  *
  * Namespace:
  *   bosch_bmp280
  *
- * Header File(s):
+ * Header File(s);
  *   bmp280.hpp
  */
-void BMP280::Force()
+void BMP280::GetConfig(uint8_t& ctrl, uint8_t& conf)
 {
-	uint8_t ctrl;
-	this->GetRegs(BMP280_R_CTRL, &ctrl, 1);
+    if (!shadowvalid)
+        this->Resync();
 
-	ctrl = (ctrl | BMP280_MODE_FORCED);
-	uint8_t dat[] { BMP280_R_CTRL, ctrl };
-	this->SetRegs(dat, 2);
+    ctrl = ctrlshadow;
+    conf = confshadow;
 }
 
 /*
- * void BMP280::Reset()
+ * void BMP280::Resync()
  *
  * Description:
- *   Resets the device. Allows time for the reset process to
- *   complete before returning.
+ *   Reads the ctrl_meas and config registers from the device, in one
+ *   transaction, into the driver's shadow copies.
+ *
+ *   Call this after anything outside of this class may have changed
+ *   the device configuration - a brown-out, another process on the
+ *   bus, or a bus error partway through a write.
+ *
+ *   The config shadow leaves out spi3w_en, which belongs to the bus
+ *   (BMP280SPIBus sets it in 3-wire mode), so that a device read back
+ *   over 3-wire SPI does not look reconfigured to Reconfigure().
  *
  * Namespace:
  *   bosch_bmp280
  *
- * Header File(s):
+ * Header File(s);
  *   bmp280.hpp
  */
-void BMP280::Reset()
+void BMP280::Resync()
 {
-    uint8_t dat[] { BMP280_R_RESET, BMP280_CMD_RESET };
-    this->SetRegs(dat, 2);
+    uint8_t dat[2];
+    this->GetRegs(BMP280_R_CTRL, dat, 2);
 
-    usleep(BMP280_RESET_DELAY);
+    ctrlshadow  = dat[0];
+    confshadow  = dat[1] & BMP280_SPI3W_MSK_OUT;
+    shadowvalid = true;
+}
+
+/*
+ * void BMP280::SetConfig(uint8_t ctrl, uint8_t conf)
+ *
+ * Description:
+ *   Resets the BMP280 to get it into Sleep mode, then writes the
+ *   ctrl and conf parameters to the ctrl_meas and config registers.
+ *
+ *   Note that the first write to ctrl_meas is done with the mode bits
+ *   masked out (ctrx). The config register is written next, followed
+ *   by the ctrl_meas register, this time with the mode bits included.
+ *
+ *   The CONFIG_DELAY constant is currently a number that I pulled out
+ *   of a hat as a reasonable amount of time before the first data
+ *   read should be attempted. The BMP280 datasheet gives the precise
+ *   method of determining what this time should be.
+ *
+ * Parameters:
+ *   ctrl - 8-bits to be written to the ctrl_meas register.
+ *   conf - 8-bits to be written to the config register.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::SetConfig(uint8_t ctrl, uint8_t conf)
+{
+    this->Reset();
+    this->WriteConfig(ctrl, conf);
+
+    usleep(BMP280_CONFIG_DELAY);
+}
+
+/*
+ * void BMP280::WriteConfig(uint8_t ctrl, uint8_t conf)
+ *
+ * Description:
+ *   Writes the ctrl and conf parameters to the ctrl_meas and config
+ *   registers, the same way SetConfig() does, but without the reset
+ *   before or the delay after.
+ *
+ *   This is the register-writing step of SetConfig(), for callers
+ *   that schedule the reset and settling delays themselves (see
+ *   BMP280Worker).
+ *
+ * Parameters:
+ *   ctrl - 8-bits to be written to the ctrl_meas register.
+ *   conf - 8-bits to be written to the config register.
+ *
+ * Initial Conditions:
+ *   The sensor must be in sleep mode.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::WriteConfig(uint8_t ctrl, uint8_t conf)
+{
+    uint8_t ctrx = (ctrl & BMP280_MODE_MSK_OUT);
+    uint8_t dat[] { BMP280_R_CTRL, ctrx, BMP280_R_CONF, conf, BMP280_R_CTRL, ctrl };
+
+    this->SetRegs(dat, 6);
+    ctrlshadow  = ((ctrl & BMP280_MODE_MSK) == BMP280_MODE_FORCED) ? ctrx : ctrl;
+    confshadow  = conf & BMP280_SPI3W_MSK_OUT;
+    shadowvalid = true;
+}
+
+/*
+ * void BMP280::SetConfig(int preset)
+ *
+ * Description:
+ *   Sets the device to one of the six available preset configurations.
+ *
+ * Parameters:
+ *   preset - An integer value between one and six, inclusive
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::SetConfig(int preset)
+{
+    uint8_t ctrl;
+    uint8_t conf;
+
+    Preset(preset, ctrl, conf);
+    this->SetConfig(ctrl, conf);
+}
+
+/*
+ * void BMP280::SetConfig(const BMP280Config& cfg)
+ *
+ * Description:
+ *   Resets the device and writes a typed configuration. See
+ *   SetConfig(uint8_t, uint8_t).
+ *
+ * Parameters:
+ *   cfg - the configuration
+ *
+ * Exceptions:
+ *   Throws runtime_error if cfg is not valid.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::SetConfig(const BMP280Config& cfg)
+{
+    cfg.Checked();
+    this->SetConfig(cfg.Ctrl(), cfg.Conf());
+}
+
+/*
+ * void BMP280::Reconfigure(uint8_t ctrl, uint8_t conf)
+ *
+ * Description:
+ *   Changes the device configuration without a reset, writing only
+ *   the registers that differ from the current settings.
+ *
+ *   1. If nothing has changed, nothing is written (unless ctrl asks
+ *      for forced mode, which always starts a conversion).
+ *   2. If only ctrl_meas has changed, it is written by itself.
+ *   3. If config has changed, the device is first put to sleep,
+ *      because config writes may be ignored in normal mode. Then
+ *      config and ctrl_meas are written, all in one bus write.
+ *
+ *   There is no reset and no BMP280_CONFIG_DELAY. In normal mode the
+ *   first reading with the new settings is available after one
+ *   measurement time (see MeasureTime()).
+ *
+ * Parameters:
+ *   ctrl - 8-bits to be written to the ctrl_meas register.
+ *   conf - 8-bits to be written to the config register.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::Reconfigure(uint8_t ctrl, uint8_t conf)
+{
+    if (!shadowvalid)
+        this->Resync();
+
+    bool forced = ((ctrl & BMP280_MODE_MSK) == BMP280_MODE_FORCED);
+
+    if ((conf & BMP280_SPI3W_MSK_OUT) != confshadow)
+    {
+        uint8_t dat[6];
+        int     len = 0;
+
+        if ((ctrlshadow & BMP280_MODE_MSK) != BMP280_MODE_SLEEP)
+        {
+            dat[len++] = BMP280_R_CTRL;
+            dat[len++] = (ctrlshadow & BMP280_MODE_MSK_OUT);
+        }
+        dat[len++] = BMP280_R_CONF;
+        dat[len++] = conf;
+        dat[len++] = BMP280_R_CTRL;
+        dat[len++] = ctrl;
+
+        this->SetRegs(dat, len);
+    }
+    else if (ctrl != ctrlshadow || forced)
+    {
+        uint8_t dat[] { BMP280_R_CTRL, ctrl };
+        this->SetRegs(dat, 2);
+    }
+
+    ctrlshadow = forced ? (ctrl & BMP280_MODE_MSK_OUT) : ctrl;
+    confshadow = conf & BMP280_SPI3W_MSK_OUT;
+}
+
+/*
+ * void BMP280::Reconfigure(int preset)
+ *
+ * Description:
+ *   Switches the device to one of the six preset configurations,
+ *   without a reset. See Reconfigure(uint8_t, uint8_t).
+ *
+ * Parameters:
+ *   preset - An integer value between one and six, inclusive
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::Reconfigure(int preset)
+{
+    uint8_t ctrl;
+    uint8_t conf;
+
+    Preset(preset, ctrl, conf);
+    this->Reconfigure(ctrl, conf);
+}
+
+/*
+ * void BMP280::Reconfigure(const BMP280Config& cfg)
+ *
+ * Description:
+ *   Switches the device to a typed configuration, without a reset.
+ *   See Reconfigure(uint8_t, uint8_t).
+ *
+ * Parameters:
+ *   cfg - the configuration
+ *
+ * Exceptions:
+ *   Throws runtime_error if cfg is not valid.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::Reconfigure(const BMP280Config& cfg)
+{
+    cfg.Checked();
+    this->Reconfigure(cfg.Ctrl(), cfg.Conf());
+}
+
+/*
+ * void BMP280::Preset(int preset, uint8_t& ctrl, uint8_t& conf)
+ *
+ * Description:
+ *   Looks up the ctrl_meas and config values for one of the six
+ *   preset configurations in BMP280Presets[]. Out-of-range presets
+ *   get preset 1.
+ *
+ * Parameters:
+ *   preset - An integer value between one and six, inclusive
+ *   ctrl   - receives the ctrl_meas value
+ *   conf   - receives the config value
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void BMP280::Preset(int preset, uint8_t& ctrl, uint8_t& conf)
+{
+    if (preset < 1 || preset > 6)
+        preset = 1;
+
+    ctrl = BMP280Presets[preset - 1].Ctrl();
+    conf = BMP280Presets[preset - 1].Conf();
+}
+
+/*
+ * void BMP280::Force()
+ *
+ * Description:
+ *   Sets the ctrl_meas register mode bits to forced.
+ *
+ *   The oversampling bits are taken from the ctrl_meas shadow copy,
+ *   so this is a single register write. The register is only read
+ *   back if the shadow is not yet valid.
+ *
+ *   The device drops back to sleep mode on its own once the
+ *   conversion is done, so that is what the shadow records.
+ *
+ * Initial Conditions:
+ *   All other configuration settings must be completed before
+ *   calling this function.
+ *
+ *   The sensor must be in sleep mode.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280.hpp
+ */
+void BMP280::Force()
+{
+	BMP280_METRIC_SCOPE(metrics, BMP280Op::Force, 0);
+
+	if (!shadowvalid)
+		this->Resync();
+
+	uint8_t ctrl = (ctrlshadow & BMP280_MODE_MSK_OUT) | BMP280_MODE_FORCED;
+	uint8_t dat[] { BMP280_R_CTRL, ctrl };
+	this->SetRegs(dat, 2);
+	ctrlshadow = (ctrl & BMP280_MODE_MSK_OUT) | BMP280_MODE_SLEEP;
+
+	BMP280_METRIC_DONE();
+}
+
+/*
+ * void BMP280::Reset()
+ *
+ * Description:
+ *   Resets the device. Allows time for the reset process to
+ *   complete before returning.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280.hpp
+ */
+void BMP280::Reset()
+{
+    this->SendReset();
+
+    usleep(BMP280_RESET_DELAY);
+}
+
+/*
+ * void BMP280::SendReset()
+ *
+ * Description:
+ *   Sends the reset command and returns immediately. The device is
+ *   not usable until BMP280_RESET_DELAY microseconds later.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280.hpp
+ */
+void BMP280::SendReset()
+{
+    BMP280_METRIC_SCOPE(metrics, BMP280Op::Reset, 0);
+
+    uint8_t dat[] { BMP280_R_RESET, BMP280_CMD_RESET };
+    this->SetRegs(dat, 2);
+    BMP280_METRIC_DONE();
+
+    ctrlshadow  = 0;
+    confshadow  = 0;
+    shadowvalid = true;
+}
+
+/*
+ * void BMP280::SetMode(uint8_t mode)
+ *
+ * Description:
+ *   Changes the ctrl_meas mode bits, leaving oversampling alone.
+ *
+ *   If the shadow copy shows that the device is already in the
+ *   requested mode, nothing is written. Forced mode is always
+ *   written, since it starts a new conversion.
+ *
+ * Parameters:
+ *   mode - BMP280_MODE_SLEEP, BMP280_MODE_FORCED or
+ *          BMP280_MODE_NORMAL
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280.hpp
+ */
+void BMP280::SetMode(uint8_t mode)
+{
+    mode &= BMP280_MODE_MSK;
+
+    if (mode == BMP280_MODE_FORCED)
+    {
+        this->Force();
+        return;
+    }
+
+    if (!shadowvalid)
+        this->Resync();
+
+    uint8_t ctrl = (ctrlshadow & BMP280_MODE_MSK_OUT) | mode;
+    if (ctrl == ctrlshadow)
+        return;
+
+    uint8_t dat[] { BMP280_R_CTRL, ctrl };
+    this->SetRegs(dat, 2);
+    ctrlshadow = ctrl;
+}
+
+/*
+ * TP32Data BMP280::MeasureForced()
+ *
+ * Description:
+ *   Takes one forced-mode measurement and applies 32-bit fixed-point
+ *   compensation.
+ *
+ *   Triggers the conversion, then sleeps for the maximum measurement
+ *   time allowed by the current oversampling settings (see
+ *   MeasureTime()). The status register is read in the same burst
+ *   as the data registers (0xF3..0xFC), so it costs no extra bus
+ *   transaction. Only if the measuring bit is still set does this
+ *   fall back to polling.
+ *
+ * Initial Conditions:
+ *   All other configuration settings must be completed before
+ *   calling this function.
+ *
+ *   The sensor must be in sleep mode.
+ *
+ * Returns:
+ *   Returns a TP32Data structure containing a time stamp, a temperature
+ *   reading (in 1/100 degrees centigrade), and a pressure reading (in
+ *   pascals).
+ *
+ * Exceptions:
+ *   runtime_error - the conversion did not finish in time
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280.hpp
+ */
+TP32Data BMP280::MeasureForced()
+{
+    TP32Data reading;
+
+    this->Force();
+
+    BMP280_METRIC_SCOPE(metrics, BMP280Op::Wait, 0);
+    usleep(MeasureTime(ctrlshadow));
+
+    for (int tries = 0; !this->ReadForced(reading); tries++)
+    {
+        if (tries >= BMP280_T_MEAS_TRIES)
+        {
+            runtime_error re {"BMP280::MeasureForced(): Measurement timed out."};
+            throw re;
+        }
+
+        usleep(BMP280_T_MEAS_POLL);
+    }
+    BMP280_METRIC_DONE();
+
+    return reading;
+}
+
+/*
+ * bool BMP280::ReadForced(TP32Data& reading)
+ *
+ * Description:
+ *   Reads the status and data registers (0xF3..0xFC) in one burst.
+ *   If the measuring bit is clear, the data is compensated and stored
+ *   in reading.
+ *
+ *   This is the non-blocking half of MeasureForced(): call Force(),
+ *   wait MeasureTime() microseconds by whatever means, then call
+ *   this.
+ *
+ * Parameters:
+ *   reading - receives the compensated reading, if one was ready
+ *
+ * Returns:
+ *   Returns true if a reading was stored, false if the conversion
+ *   is still running.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280.hpp
+ */
+bool BMP280::ReadForced(TP32Data& reading)
+{
+    // 0xF3 status, 0xF4 ctrl_meas, 0xF5 config, 0xF6 (reserved), 0xF7..0xFC data
+    uint8_t dat[10]{0};
+
+    this->GetRegs(BMP280_R_STAT, dat, 10);
+    if (dat[0] & BMP280_STATUS_MEAS)
+    {
+        BMP280_METRIC_POLL(metrics);
+        return false;
+    }
+
+    reading.Stamp();
+    this->DecodeUncomp(dat + 4, reading);
+
+    BMP280_METRIC_SCOPE(metrics, BMP280Op::Comp, 0);
+    this->Compensate(reading);
+    BMP280_METRIC_DONE();
+
+    return true;
+}
+
+/*
+ * uint8_t BMP280::GetUncompStatus(TP32Data& unc)
+ *
+ * Description:
+ *   Reads the status and data registers (0xF3..0xFC) in one burst,
+ *   and stores the raw reading, stamped, whatever the status.
+ *
+ *   In normal mode the data registers always hold the last finished
+ *   conversion, so the status byte tells the caller where the device
+ *   is in its cycle without costing another transaction (see
+ *   BMP280NormalSampler).
+ *
+ * Parameters:
+ *   unc - receives the uncompensated temperature and pressure
+ *
+ * Returns:
+ *   Returns the status register.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280.hpp
+ */
+uint8_t BMP280::GetUncompStatus(TP32Data& unc)
+{
+    uint8_t dat[10]{0};
+
+    this->GetRegs(BMP280_R_STAT, dat, 10);
+    unc.Stamp();
+    this->DecodeUncomp(dat + 4, unc);
+
+    return dat[0];
+}
+
+/*
+ * int BMP280::Oversampling(uint8_t osrs)
+ *
+ * Description:
+ *   Converts a three-bit osrs_t or osrs_p field into the number of
+ *   samples that the sensor takes.
+ *
+ * Parameters:
+ *   osrs - the oversampling field, shifted down to bits 0..2
+ *
+ * Returns:
+ *   Returns 0 (skipped), 1, 2, 4, 8 or 16.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280.hpp
+ */
+int BMP280::Oversampling(uint8_t osrs)
+{
+    return OsrsSamples((Osrs)(osrs & 0x07));
+}
+
+/*
+ * unsigned int BMP280::MeasureTime(uint8_t ctrl)
+ *
+ * Description:
+ *   Computes the maximum time that one measurement can take, given
+ *   the oversampling settings in a ctrl_meas value.
+ *
+ * Parameters:
+ *   ctrl - a ctrl_meas register value. Mode bits are ignored.
+ *
+ * Returns:
+ *   Returns the maximum measurement time, in microseconds.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280.hpp
+ */
+unsigned int BMP280::MeasureTime(uint8_t ctrl)
+{
+    return BMP280Config::FromRegs(ctrl, 0).MeasureTime();
 }
 
 } // namespace bosch_bmp280
-```
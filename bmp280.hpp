@@ -1,4 +1,3 @@
-```
 /*
  * bmp280.hpp
  *
@@ -23,55 +22,130 @@
 #define BMP280_HPP_
 
 #include  <ctime>            // time_t
+#include  <memory>           // unique_ptr
 #include  <mutex>            // mutex
 #include  <stdint.h>         // int16_t, uint16_t
 
-#include "bbb-i2c.hpp"       // I2CBus
-
+#include "bmp280_bus.hpp"    // BMP280Bus, BMP280I2CBus, I2CBus
 #include "bmp280_defs.hpp"
-#include "bmp280_comp.hpp"
+#include "bmp280_comp.hpp"   // Cal32Fixed
+#include "bmp280_config.hpp" // BMP280Config
+#include "bmp280_metrics.hpp"  // BMP280Metrics, BMP280_METRICS
 
+#if BMP280_BBBI2C
 using bbbi2c::I2CBus;
+#endif
 
 namespace bosch_bmp280
 {
 
+// Number of readings buffered when a batch is pushed
+// straight into a TP32DataQueue.
+#define BMP280_BATCH_CHUNK  32
+
 class BMP280
 {
   protected:
 
-    I2CBus*    i2cbus;
+    BMP280Bus* bus;
+    std::unique_ptr<BMP280Bus> ownbus;   // adapter made by the I2CBus constructor
     uint8_t    i2caddr;
     int32_t    tfine;
     CalParams  cparams;
+    Cal32Fixed ccal;                 // cparams, compiled for compensation
+    uint8_t    calraw[BMP280_CAL_SIZE];  // cparams, as read from the ROM
+    TP32Data   batch[BMP280_BATCH_CHUNK];
+
+    uint8_t    ctrlshadow;           // shadow copy of ctrl_meas
+    uint8_t    confshadow;           // shadow copy of config
+    bool       shadowvalid;          // shadows match the device
+
+#if BMP280_METRICS
+    BMP280Metrics  metrics;
+#endif
 
     void  GetRegs ( uint8_t startaddr, uint8_t* data, int len );
     void  SetRegs ( uint8_t* data, int len );
+
+    void  DecodeUncomp ( const uint8_t* dat, TP32Data& unc );
+    void  Compensate   ( TP32Data& reading );
+    void  DecodeCalParams ();
 	
   public:
     
     std::mutex mtx;
 
-    BMP280 ( I2CBus* bus, uint8_t addr );
+    BMP280 ( BMP280Bus* devbus, uint8_t addr );
+#if BMP280_BBBI2C
+    BMP280 ( I2CBus* i2cbus, uint8_t addr );
+#endif
     ~BMP280 ();
 
-    void      LoadCalParams ();
+    BMP280Bus*  Bus     () const { return bus;     }
+    uint8_t     Address () const { return i2caddr; }
+
+#if BMP280_METRICS
+    BMP280Metrics&  Metrics () { return metrics; }
+#endif
+
+    void     LoadCalParams   ();
+    void     GetCalRaw       ( uint8_t* dat );
+    void     SetCalRaw       ( const uint8_t* dat );
+    bool     VerifyCalParams ();
+    uint8_t  GetChipId       ();
+
+    // Calibration, compiled for compensation policy Cal. Loads the
+    // calibration parameters first, if necessary.
+    template<class Cal = Cal32Fixed>
+    Cal  Calibration ()
+    {
+        if (!cparams.loaded) this->LoadCalParams();
+        return Cal(cparams);
+    }
+
+    // One reading, compensated by policy Cal (see bmp280_comp.hpp).
+    template<class Cal>
+    typename Cal::Data  GetCompData ( const Cal& cal )
+    {
+        return cal.Compensate(this->GetUncompData());
+    }
     int32_t   Comp32FixedTemp  (  int32_t unctemp  );
     uint32_t  Comp32FixedPress ( uint32_t uncpress );
 
     TP32Data  GetUncompData ();
     TP32Data  GetComp32FixedData ();
 
+    int  GetUncompData      ( TP32Data* buf, int count, unsigned int interval=0 );
+    int  GetComp32FixedData ( TP32Data* buf, int count, unsigned int interval=0 );
+    int  GetComp32FixedData ( TP32DataQueue& queue, int count, unsigned int interval=0 );
+
     void  GetConfig ( uint8_t& ctrl, uint8_t& conf );
+    void  Resync ();
     void  SetConfig ( int preset );
     void  SetConfig ( uint8_t ctrl, uint8_t conf );
+    void  SetConfig ( const BMP280Config& cfg );
+    void  WriteConfig ( uint8_t ctrl, uint8_t conf );
+
+    void  Reconfigure ( int preset );
+    void  Reconfigure ( uint8_t ctrl, uint8_t conf );
+    void  Reconfigure ( const BMP280Config& cfg );
+
+    static void  Preset ( int preset, uint8_t& ctrl, uint8_t& conf );
 
     void  Force ();
     void  Reset ();
+    void  SendReset ();
+    void  SetMode ( uint8_t mode );
+
+    TP32Data  MeasureForced ();
+    bool      ReadForced ( TP32Data& reading );
+    uint8_t   GetUncompStatus ( TP32Data& unc );
+
+    static int           Oversampling ( uint8_t osrs );
+    static unsigned int  MeasureTime  ( uint8_t ctrl );
 
 }; // class BMP280
 
 } // namespace bosch_bmp280b
 
 #endif /* BMP280_HPP_ */
-```
@@ -0,0 +1,478 @@
+/*
+ * bmp280_async.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Asynchronous, non-blocking operations on BMP280 devices.
+ *
+ *  Notes:
+ *    1. Jobs run without jobmtx held, so a job may Post() further
+ *       jobs. That is how multi-step operations chain themselves.
+ *    2. std::function needs copyable targets, so promises are held
+ *       by shared_ptr.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <chrono>            // steady_clock, microseconds
+#include <exception>         // current_exception()
+#include <future>            // future, promise
+#include <memory>            // shared_ptr, make_shared
+#include <mutex>             // mutex, lock_guard, unique_lock
+#include <stdexcept>         // runtime_error
+
+#include "bmp280_async.hpp"  // BMP280Worker
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+// BMP280Worker Constructor, Destructor
+// -----------------------------------------------------------------
+
+/*
+ * BMP280Worker::BMP280Worker()
+ *
+ * Description:
+ *   Constructor. The worker starts out idle: call Start() to run it
+ *   on its own thread, or call Poll() from an existing loop.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+BMP280Worker::BMP280Worker()
+{
+    jobseq  = 0;
+    running = false;
+}
+
+/*
+ * BMP280Worker::~BMP280Worker()
+ *
+ * Description:
+ *   Destructor. Stops the worker thread, if it is running. Jobs that
+ *   have not run yet are discarded, and their futures report a
+ *   broken promise.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+BMP280Worker::~BMP280Worker()
+{
+    this->Stop();
+}
+
+
+// BMP280Worker Protected
+// -----------------------------------------------------------------
+
+/*
+ * void BMP280Worker::Loop()
+ *
+ * Description:
+ *   Worker thread body. Runs jobs as they fall due, and waits on the
+ *   condition variable for the next due time or a new job otherwise.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+void BMP280Worker::Loop()
+{
+    unique_lock<mutex> lock(jobmtx);
+
+    while (running)
+    {
+        if (jobs.empty())
+        {
+            jobcv.wait(lock);
+            continue;
+        }
+
+        Clock::time_point due = jobs.top().due;
+        if (Clock::now() < due)
+        {
+            jobcv.wait_until(lock, due);
+            continue;
+        }
+
+        function<void()> fn = jobs.top().fn;
+        jobs.pop();
+
+        lock.unlock();
+        fn();
+        lock.lock();
+    }
+}
+
+/*
+ * void BMP280Worker::ReadForcedJob(BMP280* dev,
+ *          shared_ptr<promise<TP32Data>> done, int tries)
+ *
+ * Description:
+ *   Second step of MeasureForced(). Tries to read a finished forced
+ *   conversion. If the device is still measuring, schedules itself
+ *   again after BMP280_T_MEAS_POLL microseconds.
+ *
+ * Parameters:
+ *   dev   - the device
+ *   done  - receives the reading, or an exception
+ *   tries - the number of times the read has already been tried
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+void BMP280Worker::ReadForcedJob(BMP280* dev, shared_ptr< promise<TP32Data> > done, int tries)
+{
+    try
+    {
+        TP32Data reading;
+        if (dev->ReadForced(reading))
+        {
+            done->set_value(reading);
+        }
+        else if (tries >= BMP280_T_MEAS_TRIES)
+        {
+            runtime_error re {"BMP280Worker::MeasureForced(): Measurement timed out."};
+            throw re;
+        }
+        else
+        {
+            this->Post([this, dev, done, tries]() { this->ReadForcedJob(dev, done, tries + 1); },
+                       BMP280_T_MEAS_POLL);
+        }
+    }
+    catch (...)
+    {
+        done->set_exception(current_exception());
+    }
+}
+
+
+// BMP280Worker Public
+// -----------------------------------------------------------------
+
+/*
+ * void BMP280Worker::Start()
+ *
+ * Description:
+ *   Starts running jobs on a new worker thread. Does nothing if the
+ *   thread is already running.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+void BMP280Worker::Start()
+{
+    lock_guard<mutex> lock(jobmtx);
+
+    if (running)
+        return;
+
+    running = true;
+    worker  = thread(&BMP280Worker::Loop, this);
+}
+
+/*
+ * void BMP280Worker::Stop()
+ *
+ * Description:
+ *   Stops the worker thread and waits for it to exit. A job that is
+ *   running is allowed to finish. Jobs that are still queued stay
+ *   queued, and run if the worker is started again.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+void BMP280Worker::Stop()
+{
+    {
+        lock_guard<mutex> lock(jobmtx);
+        running = false;
+    }
+    jobcv.notify_all();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+/*
+ * long BMP280Worker::Poll()
+ *
+ * Description:
+ *   Runs every job that is due, on the calling thread, and returns
+ *   without waiting. For use from an existing event loop in place of
+ *   Start().
+ *
+ * Returns:
+ *   Returns the number of microseconds until the next job falls due
+ *   (zero if one is already due), or -1 if no jobs are queued. The
+ *   caller can use this as its poll/select timeout.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+long BMP280Worker::Poll()
+{
+    unique_lock<mutex> lock(jobmtx);
+
+    while (!jobs.empty() && jobs.top().due <= Clock::now())
+    {
+        function<void()> fn = jobs.top().fn;
+        jobs.pop();
+
+        lock.unlock();
+        fn();
+        lock.lock();
+    }
+
+    if (jobs.empty())
+        return -1;
+
+    Clock::duration wait = jobs.top().due - Clock::now();
+    if (wait < Clock::duration::zero())
+        return 0;
+
+    return (long)chrono::duration_cast<chrono::microseconds>(wait).count();
+}
+
+/*
+ * void BMP280Worker::Post(function<void()> fn, unsigned int delay)
+ *
+ * Description:
+ *   Queues a job to run on the worker.
+ *
+ * Parameters:
+ *   fn    - the job
+ *   delay - optional. Microseconds from now until the job is due.
+ *           The default is zero.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+void BMP280Worker::Post(function<void()> fn, unsigned int delay)
+{
+    {
+        lock_guard<mutex> lock(jobmtx);
+
+        Job job;
+        job.due = Clock::now() + chrono::microseconds(delay);
+        job.seq = jobseq++;
+        job.fn  = fn;
+        jobs.push(job);
+    }
+    jobcv.notify_one();
+}
+
+/*
+ * future<TP32Data> BMP280Worker::MeasureForced(BMP280& dev)
+ *
+ * Description:
+ *   Takes one forced-mode measurement without blocking.
+ *
+ *   The conversion is triggered, and the read is scheduled for the
+ *   maximum measurement time later (see BMP280::MeasureTime()).
+ *
+ * Parameters:
+ *   dev - the device. Must be configured and in sleep mode.
+ *
+ * Returns:
+ *   Returns a future for the compensated reading.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+future<TP32Data> BMP280Worker::MeasureForced(BMP280& dev)
+{
+    shared_ptr< promise<TP32Data> > done = make_shared< promise<TP32Data> >();
+    BMP280* pdev = &dev;
+
+    this->Post([this, pdev, done]()
+    {
+        try
+        {
+            uint8_t ctrl, conf;
+
+            pdev->Force();
+            pdev->GetConfig(ctrl, conf);
+            this->Post([this, pdev, done]() { this->ReadForcedJob(pdev, done, 0); },
+                       BMP280::MeasureTime(ctrl));
+        }
+        catch (...)
+        {
+            done->set_exception(current_exception());
+        }
+    });
+
+    return done->get_future();
+}
+
+/*
+ * future<TP32Data> BMP280Worker::GetComp32FixedData(BMP280& dev)
+ *
+ * Description:
+ *   Retrieves the latest temperature and pressure reading, with
+ *   32-bit fixed-point compensation, on the worker.
+ *
+ * Parameters:
+ *   dev - the device
+ *
+ * Returns:
+ *   Returns a future for the compensated reading.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+future<TP32Data> BMP280Worker::GetComp32FixedData(BMP280& dev)
+{
+    shared_ptr< promise<TP32Data> > done = make_shared< promise<TP32Data> >();
+    BMP280* pdev = &dev;
+
+    this->Post([pdev, done]()
+    {
+        try
+        {
+            done->set_value(pdev->GetComp32FixedData());
+        }
+        catch (...)
+        {
+            done->set_exception(current_exception());
+        }
+    });
+
+    return done->get_future();
+}
+
+/*
+ * future<void> BMP280Worker::SetConfig(BMP280& dev, uint8_t ctrl, uint8_t conf)
+ *
+ * Description:
+ *   Resets the device and writes a new configuration, like
+ *   BMP280::SetConfig(), with the reset and configuration delays
+ *   scheduled on the worker rather than slept through.
+ *
+ * Parameters:
+ *   dev  - the device
+ *   ctrl - 8-bits to be written to the ctrl_meas register.
+ *   conf - 8-bits to be written to the config register.
+ *
+ * Returns:
+ *   Returns a future that is ready once the configuration delay has
+ *   passed.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+future<void> BMP280Worker::SetConfig(BMP280& dev, uint8_t ctrl, uint8_t conf)
+{
+    shared_ptr< promise<void> > done = make_shared< promise<void> >();
+    BMP280* pdev = &dev;
+
+    this->Post([this, pdev, done, ctrl, conf]()
+    {
+        try
+        {
+            pdev->SendReset();
+            this->Post([this, pdev, done, ctrl, conf]()
+            {
+                try
+                {
+                    pdev->WriteConfig(ctrl, conf);
+                    this->Post([done]() { done->set_value(); }, BMP280_CONFIG_DELAY);
+                }
+                catch (...)
+                {
+                    done->set_exception(current_exception());
+                }
+            },
+            BMP280_RESET_DELAY);
+        }
+        catch (...)
+        {
+            done->set_exception(current_exception());
+        }
+    });
+
+    return done->get_future();
+}
+
+/*
+ * future<void> BMP280Worker::Reconfigure(BMP280& dev, uint8_t ctrl, uint8_t conf)
+ *
+ * Description:
+ *   Runs BMP280::Reconfigure() on the worker. No delays are involved.
+ *
+ * Parameters:
+ *   dev  - the device
+ *   ctrl - 8-bits to be written to the ctrl_meas register.
+ *   conf - 8-bits to be written to the config register.
+ *
+ * Returns:
+ *   Returns a future that is ready once the registers are written.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+future<void> BMP280Worker::Reconfigure(BMP280& dev, uint8_t ctrl, uint8_t conf)
+{
+    shared_ptr< promise<void> > done = make_shared< promise<void> >();
+    BMP280* pdev = &dev;
+
+    this->Post([pdev, done, ctrl, conf]()
+    {
+        try
+        {
+            pdev->Reconfigure(ctrl, conf);
+            done->set_value();
+        }
+        catch (...)
+        {
+            done->set_exception(current_exception());
+        }
+    });
+
+    return done->get_future();
+}
+
+} // namespace bosch_bmp280
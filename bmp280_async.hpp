@@ -0,0 +1,119 @@
+/*
+ * bmp280_async.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Asynchronous, non-blocking operations on BMP280 devices.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_ASYNC_HPP_
+#define BMP280_ASYNC_HPP_
+
+#include <chrono>              // steady_clock
+#include <condition_variable>  // condition_variable
+#include <functional>          // function
+#include <future>              // future, promise
+#include <memory>              // shared_ptr
+#include <mutex>               // mutex
+#include <queue>               // priority_queue
+#include <stdint.h>            // uint8_t, uint64_t
+#include <thread>              // thread
+#include <vector>              // vector
+
+#include "bmp280.hpp"          // BMP280
+
+namespace bosch_bmp280
+{
+
+/*
+ * class BMP280Worker
+ *
+ * Description:
+ *   An event loop that drives any number of BMP280 devices from one
+ *   thread, without sleeping between the steps of an operation.
+ *
+ *   Each operation is broken into short jobs - a register write, a
+ *   burst read - and the delays between them (reset, settling,
+ *   conversion time) are scheduled as timers instead of usleep()
+ *   calls. While one device is converting, the loop is free to run
+ *   jobs for the others.
+ *
+ *   Operations return a std::future that becomes ready when the last
+ *   job completes. Exceptions thrown by the bus are delivered
+ *   through the future.
+ *
+ *   The loop can run on its own thread (Start(), Stop()), or be
+ *   driven from an existing event loop by calling Poll().
+ *
+ *   All bus traffic for a device must go through one worker. The
+ *   BMP280 objects must outlive any operation queued on them.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_async.hpp
+ */
+class BMP280Worker
+{
+  protected:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Job
+    {
+        Clock::time_point      due;
+        uint64_t               seq;  // keeps jobs due at the same time in order
+        std::function<void()>  fn;
+    };
+
+    struct JobLater
+    {
+        bool operator() ( const Job& a, const Job& b ) const
+        {
+            return (a.due != b.due) ? (a.due > b.due) : (a.seq > b.seq);
+        }
+    };
+
+    std::priority_queue<Job, std::vector<Job>, JobLater> jobs;
+    uint64_t                 jobseq;
+    std::mutex               jobmtx;
+    std::condition_variable  jobcv;
+    std::thread              worker;
+    bool                     running;
+
+    void  Loop ();
+
+    void  ReadForcedJob ( BMP280* dev, std::shared_ptr< std::promise<TP32Data> > done, int tries );
+
+  public:
+
+    BMP280Worker ();
+    ~BMP280Worker ();
+
+    void  Start ();
+    void  Stop  ();
+    long  Poll  ();
+
+    void  Post ( std::function<void()> fn, unsigned int delay=0 );
+
+    std::future<TP32Data>  MeasureForced      ( BMP280& dev );
+    std::future<TP32Data>  GetComp32FixedData ( BMP280& dev );
+    std::future<void>      SetConfig          ( BMP280& dev, uint8_t ctrl, uint8_t conf );
+    std::future<void>      Reconfigure        ( BMP280& dev, uint8_t ctrl, uint8_t conf );
+
+}; // class BMP280Worker
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_ASYNC_HPP_ */
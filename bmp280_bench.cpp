@@ -0,0 +1,595 @@
+/*
+ * bmp280_bench.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Benchmarks for the compensation, queue and driver hot paths.
+ *
+ *  Notes:
+ *    1. Build it with the Makefile, for the target and with the flags
+ *       being measured:
+ *
+ *         make bmp280_bench SIMD=-mavx2
+ *
+ *       It needs neither a sensor nor the bbbi2c library (it is built
+ *       with BMP280_BBBI2C=0); the driver benchmarks run against a
+ *       register file of their own and BMP280SimBus. Without SIMD the
+ *       Makefile builds it for the host (-march=native), so that the
+ *       _simd benchmarks run the host's vector kernels.
+ *
+ *    2. Usage:  bmp280_bench [filter [min_ms]]
+ *       Runs the benchmarks whose names contain filter (all of them by
+ *       default), each for at least min_ms milliseconds (default 200).
+ *    3. Output is JSON Lines on stdout, one object per result, so runs
+ *       on different hosts can be collected and compared by a script.
+ *       The first line, bench "meta", describes the build.
+ *    4. Build once with -DBMP280_METRICS=1 and once without to see
+ *       what the instrumentation costs on the driver paths.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <chrono>                // steady_clock
+#include <cstdio>                // printf(), fprintf()
+#include <cstdlib>               // atoi()
+#include <cstring>               // memcpy(), memset(), strstr()
+#include <memory>                // unique_ptr
+#include <stdint.h>              // int32_t, uint32_t, uint64_t, INT32_MIN, ...
+#include <vector>                // vector
+
+#include "bmp280.hpp"            // BMP280, TP32Data, TP32DataQueue
+#include "bmp280_bus.hpp"        // BMP280Bus
+#include "bmp280_comp.hpp"       // Cal32Fixed, Cal64Fixed, CalDouble
+#include "bmp280_pyramid.hpp"    // TP32Pyramid
+#include "bmp280_sched.hpp"      // BMP280BusScheduler
+#include "bmp280_series.hpp"     // TP32Series
+#include "bmp280_sim.hpp"        // BMP280SimBus
+#include "bmp280_simd.hpp"       // Comp32FixedBatch(), SummarizeI32(), SummarizeU32()
+
+using namespace std;
+using namespace bosch_bmp280;
+
+
+// Mock Bus
+// -----------------------------------------------------------------
+
+/*
+ * A 256-byte register file standing in for the sensor. Calibration is
+ * the datasheet example (BMP280 datasheet, section 3.12), the chip id
+ * is BMP280_ID, and the status register always reads idle, so every
+ * transfer costs only the driver's own work.
+ */
+class MockBus : public BMP280Bus
+{
+  protected:
+    uint8_t regs[256];
+
+  public:
+
+    MockBus ()
+    {
+        const int16_t cal[12] = { 27504, 26435, -1000, (int16_t)36477, -10685, 3024,
+                                  2855, 140, -7, 15500, -14600, 6000 };
+        const uint32_t up = 415148;
+        const uint32_t ut = 519888;
+
+        memset(regs, 0, sizeof(regs));
+        for (int i = 0; i < 12; i++)
+        {
+            regs[BMP280_R_CAL_T1L + 2*i]     = (uint8_t)(cal[i] & 0xFF);
+            regs[BMP280_R_CAL_T1L + 2*i + 1] = (uint8_t)((cal[i] >> 8) & 0xFF);
+        }
+        regs[BMP280_R_ID] = BMP280_ID;
+
+        regs[BMP280_R_PMSB]  = (uint8_t)(up >> 12);
+        regs[BMP280_R_PLSB]  = (uint8_t)(up >> 4);
+        regs[BMP280_R_PXLSB] = (uint8_t)(up << 4);
+        regs[BMP280_R_TMSB]  = (uint8_t)(ut >> 12);
+        regs[BMP280_R_TLSB]  = (uint8_t)(ut >> 4);
+        regs[BMP280_R_TXLSB] = (uint8_t)(ut << 4);
+    }
+
+    void Read ( uint8_t addr, uint8_t reg, uint8_t* data, int len ) override
+    {
+        (void)addr;
+        memcpy(data, regs + reg, len);
+    }
+
+    void Write ( uint8_t addr, uint8_t* data, int len ) override
+    {
+        (void)addr;
+        for (int i = 0; i + 1 < len; i += 2)
+            regs[data[i]] = data[i + 1];
+    }
+};
+
+
+// Harness
+// -----------------------------------------------------------------
+
+static const char* filter = "";
+static double      minns  = 200e6;
+static volatile uint64_t sink;           // keeps results alive
+
+/*
+ * Runs body(n), which performs n operations, with n doubling until one
+ * run takes at least minns, then prints the result of that run. n is
+ * always a multiple of unit, for bodies that work in fixed batches.
+ */
+template<class F>
+static void Bench(const char* name, long param, F body, uint64_t unit=1)
+{
+    if (!strstr(name, filter))
+        return;
+
+    uint64_t n = unit;
+    double   ns;
+
+    for (;;)
+    {
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        body(n);
+        chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+
+        ns = (double)chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count();
+        if (ns >= minns || n >= (1ull << 40))
+            break;
+        n *= 2;
+    }
+
+    printf("{\"bench\":\"%s\",\"param\":%ld,\"iters\":%llu,\"ns_per_op\":%.3f,\"ops_per_sec\":%.1f}\n",
+           name, param, (unsigned long long)n, ns/n, n*1e9/ns);
+    fflush(stdout);
+}
+
+/*
+ * Raw readings around the datasheet example: a slow random walk, the
+ * way a real sensor's output moves.
+ */
+static void RawInputs(vector<TP32Data>& raw, size_t count)
+{
+    uint32_t lcg = 12345;
+    int32_t  ut  = 519888;
+    uint32_t up  = 415148;
+
+    raw.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        lcg = lcg*1664525 + 1013904223;
+        ut += (int32_t)((lcg >> 8) % 65) - 32;
+        up += (uint32_t)((lcg >> 16) % 129) - 64;
+        raw[i] = TP32Data(ut, up);
+        raw[i].timestamp = (time_t)(1700000000 + i);
+    }
+}
+
+static const char* Arch()
+{
+#if defined(__aarch64__)
+    return "aarch64";
+#elif defined(__arm__)
+    return "arm";
+#elif defined(__x86_64__)
+    return "x86_64";
+#elif defined(__i386__)
+    return "x86";
+#else
+    return "unknown";
+#endif
+}
+
+static const char* Simd()
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "neon";
+#elif defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE4_1__)
+    return "sse4.1";
+#else
+    return "scalar";
+#endif
+}
+
+
+// Benchmarks
+// -----------------------------------------------------------------
+
+static void CompBenches(BMP280& dev)
+{
+    const size_t N = 4096;
+    vector<TP32Data> raw, out(N);
+    RawInputs(raw, N);
+
+    vector<int32_t>  ut(N), t(N);
+    vector<uint32_t> up(N), p(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        ut[i] = raw[i].temperature;
+        up[i] = raw[i].pressure;
+    }
+
+    Cal32Fixed c32 = dev.Calibration<Cal32Fixed>();
+    Cal64Fixed c64 = dev.Calibration<Cal64Fixed>();
+    CalDouble  cd  = dev.Calibration<CalDouble>();
+
+    Bench("comp_reference", 0, [&](uint64_t n)
+    {
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++)
+        {
+            const TP32Data& r = raw[i % N];
+            acc += (uint32_t)dev.Comp32FixedTemp(r.temperature);
+            acc += dev.Comp32FixedPress(r.pressure);
+        }
+        sink = acc;
+    });
+
+    Bench("comp_cal32fixed", 0, [&](uint64_t n)
+    {
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++)
+            acc += c32.Compensate(raw[i % N]).pressure;
+        sink = acc;
+    });
+
+    Bench("comp_cal64fixed", 0, [&](uint64_t n)
+    {
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++)
+            acc += c64.Compensate(raw[i % N]).pressure;
+        sink = acc;
+    });
+
+    Bench("comp_caldouble", 0, [&](uint64_t n)
+    {
+        double acc = 0.0;
+        for (uint64_t i = 0; i < n; i++)
+            acc += cd.Compensate(raw[i % N]).pressure;
+        sink = (uint64_t)acc;
+    });
+
+    // Batch kernels: one op is one sample, in runs of N.
+    Bench("comp_batch_scalar", (long)N, [&](uint64_t n)
+    {
+        for (uint64_t done = 0; done < n; done += N)
+            Comp32Fixed(c32, raw.data(), out.data(), N);
+        sink = out[0].pressure;
+    }, N);
+
+    Bench("comp_batch_simd", (long)N, [&](uint64_t n)
+    {
+        for (uint64_t done = 0; done < n; done += N)
+            Comp32FixedBatch(c32, ut.data(), up.data(), t.data(), p.data(), N);
+        sink = p[0];
+    }, N);
+}
+
+/*
+ * Scalar reference for SummarizeI32() and SummarizeU32(): the one
+ * reading at a time loop that TP32DataQueue ran before the kernels,
+ * kept here so the queue_summarize pairs measure the gain.
+ */
+template<class T>
+static void SummarizeRef(const T* data, size_t len, T ref,
+                         T& high, T& low, int64_t& sum, int64_t& sumsq)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        T       v = data[i];
+        int64_t d = (int64_t)v - (int64_t)ref;
+        if (v > high) high = v;
+        if (v < low)  low  = v;
+        sum   += d;
+        sumsq += d * d;
+    }
+}
+
+/*
+ * Temperature and pressure columns of the queue's own sizes, summarized
+ * by the scalar reference and by the kernels. One op is one reading.
+ * On a build without vector flags the kernels are scalar too; the meta
+ * line says which was built.
+ */
+static void KernelBenches(const vector<TP32Data>& raw)
+{
+    const size_t lens[] = { 60, 600, 6000, 60000 };
+
+    vector<int32_t>  t(raw.size());
+    vector<uint32_t> p(raw.size());
+    for (size_t i = 0; i < raw.size(); i++)
+    {
+        t[i] = raw[i].temperature;
+        p[i] = raw[i].pressure;
+    }
+
+    for (size_t len : lens)
+    {
+        const int32_t  tr = t[0];
+        const uint32_t pr = p[0];
+
+        int32_t  th, tl;
+        uint32_t ph, pl;
+        int64_t  ts, tq, ps, pq;
+
+        // Both must agree before either is timed.
+        int32_t  th2 = INT32_MIN, tl2 = INT32_MAX;
+        uint32_t ph2 = 0,         pl2 = UINT32_MAX;
+        int64_t  ts2 = 0, tq2 = 0, ps2 = 0, pq2 = 0;
+
+        th = INT32_MIN; tl = INT32_MAX; ph = 0; pl = UINT32_MAX;
+        ts = tq = ps = pq = 0;
+        SummarizeRef(t.data(), len, tr, th, tl, ts, tq);
+        SummarizeRef(p.data(), len, pr, ph, pl, ps, pq);
+        SummarizeI32(t.data(), len, tr, th2, tl2, ts2, tq2);
+        SummarizeU32(p.data(), len, pr, ph2, pl2, ps2, pq2);
+
+        if (th != th2 || tl != tl2 || ts != ts2 || tq != tq2 ||
+            ph != ph2 || pl != pl2 || ps != ps2 || pq != pq2)
+        {
+            fprintf(stderr, "queue_summarize: kernel and reference disagree, len %zu\n", len);
+            continue;
+        }
+
+        Bench("queue_summarize_scalar", (long)len, [&](uint64_t n)
+        {
+            int64_t acc = 0;
+            for (uint64_t done = 0; done < n; done += len)
+            {
+                th = INT32_MIN; tl = INT32_MAX; ph = 0; pl = UINT32_MAX;
+                ts = tq = ps = pq = 0;
+                SummarizeRef(t.data(), len, tr, th, tl, ts, tq);
+                SummarizeRef(p.data(), len, pr, ph, pl, ps, pq);
+                acc += ts + pq + th + pl;
+            }
+            sink = (uint64_t)acc;
+        }, len);
+
+        Bench("queue_summarize_simd", (long)len, [&](uint64_t n)
+        {
+            int64_t acc = 0;
+            for (uint64_t done = 0; done < n; done += len)
+            {
+                th = INT32_MIN; tl = INT32_MAX; ph = 0; pl = UINT32_MAX;
+                ts = tq = ps = pq = 0;
+                SummarizeI32(t.data(), len, tr, th, tl, ts, tq);
+                SummarizeU32(p.data(), len, pr, ph, pl, ps, pq);
+                acc += ts + pq + th + pl;
+            }
+            sink = (uint64_t)acc;
+        }, len);
+    }
+}
+
+static void QueueBenches()
+{
+    const int caps[] = { 60, 600, 6000, 60000 };
+    const struct { const char* push; const char* sum; const char* range; int opts; } modes[] =
+    {
+        { "queue_push",             "queue_push_summarize",             "queue_range",             TP32Q_OPT_NONE },
+        { "queue_push_incremental", "queue_push_summarize_incremental", "queue_range_incremental", TP32Q_OPT_INCREMENTAL },
+        { "queue_push_range",       "queue_push_summarize_range",       "queue_range_range",       TP32Q_OPT_RANGE },
+        { "queue_push_snapshot",    "queue_push_summarize_snapshot",    "queue_range_snapshot",
+          TP32Q_OPT_INCREMENTAL | TP32Q_OPT_SNAPSHOT },
+    };
+
+    vector<TP32Data> raw;
+    RawInputs(raw, 65536);
+    KernelBenches(raw);
+
+    for (const auto& m : modes)
+    {
+        for (int cap : caps)
+        {
+            TP32DataQueue q(cap, m.opts);
+            for (int i = 0; i < cap; i++)
+                q.push(raw[i & 0xFFFF]);
+
+            // Steady state: every push also drops the oldest reading.
+            Bench(m.push, cap, [&](uint64_t n)
+            {
+                for (uint64_t i = 0; i < n; i++)
+                    q.push(raw[i & 0xFFFF]);
+                sink = q.size();
+            });
+
+            Bench(m.sum, cap, [&](uint64_t n)
+            {
+                double acc = 0.0;
+                for (uint64_t i = 0; i < n; i++)
+                {
+                    q.push(raw[i & 0xFFFF]);
+                    acc += q.TemperatureSummary().average;
+                }
+                sink = (uint64_t)acc;
+            });
+
+            // Time stamps must not decrease, so refill in order.
+            TP32DataQueue rq(cap, m.opts);
+            for (int i = 0; i < cap; i++)
+            {
+                TP32Data d = raw[i & 0xFFFF];
+                d.timestamp = (time_t)i;
+                rq.push(d);
+            }
+
+            // The middle half of the window.
+            Bench(m.range, cap, [&](uint64_t n)
+            {
+                TP32Summary ts, ps;
+                uint64_t acc = 0;
+                for (uint64_t i = 0; i < n; i++)
+                    acc += rq.RangeSummary(cap/4 + (time_t)(i & 7), 3*cap/4, ts, ps);
+                sink = acc;
+            });
+        }
+    }
+}
+
+static void HistoryBenches()
+{
+    vector<TP32Data> raw;
+    RawInputs(raw, 65536);
+
+    Bench("series_append", BMP280_SERIES_CHUNK, [&](uint64_t n)
+    {
+        TP32Series s(1 << 20);
+        for (uint64_t i = 0; i < n; i++)
+        {
+            TP32Data d = raw[i & 0xFFFF];
+            d.timestamp = (time_t)i;
+            s.Append(d);
+        }
+        sink = s.Bytes();
+    });
+
+    Bench("pyramid_push", 0, [&](uint64_t n)
+    {
+        TP32Pyramid py;
+        for (uint64_t i = 0; i < n; i++)
+        {
+            TP32Data d = raw[i & 0xFFFF];
+            d.timestamp = (time_t)i;
+            py.Push(d);
+        }
+        sink = py.Buckets(0);
+    });
+}
+
+static void DriverBenches(BMP280& dev)
+{
+    TP32Data buf[64];
+    TP32DataQueue q(600, TP32Q_OPT_INCREMENTAL);
+
+    Bench("e2e_uncomp", 1, [&](uint64_t n)
+    {
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++)
+            acc += dev.GetUncompData().pressure;
+        sink = acc;
+    });
+
+    Bench("e2e_comp32fixed", 1, [&](uint64_t n)
+    {
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++)
+            acc += dev.GetComp32FixedData().pressure;
+        sink = acc;
+    });
+
+    // One op is one sample.
+    Bench("e2e_comp32fixed_batch", 64, [&](uint64_t n)
+    {
+        for (uint64_t done = 0; done < n; done += 64)
+            dev.GetComp32FixedData(buf, 64);
+        sink = buf[0].pressure;
+    }, 64);
+
+    Bench("e2e_comp32fixed_queue", BMP280_BATCH_CHUNK, [&](uint64_t n)
+    {
+        for (uint64_t done = 0; done < n; done += BMP280_BATCH_CHUNK)
+            dev.GetComp32FixedData(q, BMP280_BATCH_CHUNK);
+        sink = q.size();
+    }, BMP280_BATCH_CHUNK);
+
+    Bench("e2e_readforced", 1, [&](uint64_t n)
+    {
+        TP32Data reading;
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++)
+        {
+            dev.ReadForced(reading);
+            acc += reading.pressure;
+        }
+        sink = acc;
+    });
+}
+
+/*
+ * Scheduler cycles over simulated sensors in normal mode, spread over
+ * as many simulated buses as it takes, 100 to a bus. One op is one
+ * reading. Zero bus latency, so this is the host's own cost per
+ * sensor; the _i2c variants add 400 kHz transfer times.
+ */
+static void SimBenches()
+{
+    const long counts[] = { 10, 100, 1000, 5000 };
+    const struct { const char* name; unsigned xfer, byte; } buses[] =
+    {
+        { "sched_sim_normal",     0,     0     },
+        { "sched_sim_normal_i2c", 50000, 22500 },
+    };
+
+    for (const auto& b : buses)
+    {
+        for (long count : counts)
+        {
+            if (!strstr(b.name, filter))
+                continue;
+
+            vector<unique_ptr<BMP280SimBus>>       simbus;
+            vector<unique_ptr<BMP280BusScheduler>> sched;
+            vector<unique_ptr<BMP280>>             devs;
+            vector<TP32Data>                       out(100);
+
+            for (long i = 0; i < count; i++)
+            {
+                if (i % 100 == 0)
+                {
+                    simbus.emplace_back(new BMP280SimBus(b.xfer, b.byte));
+                    sched.emplace_back(new BMP280BusScheduler(simbus.back().get()));
+                }
+                uint8_t addr = (uint8_t)(i % 100);
+                simbus.back()->Add(addr).SetEnvironment(15.0 + i*0.001, 100000.0 + i);
+                devs.emplace_back(new BMP280(simbus.back().get(), addr));
+                devs.back()->LoadCalParams();
+                devs.back()->WriteConfig(BMP280Config(Osrs::X1, Osrs::X1, Mode::Normal).Ctrl(), 0);
+                sched.back()->Add(devs.back().get());
+            }
+
+            Bench(b.name, count, [&](uint64_t n)
+            {
+                uint64_t acc = 0;
+                for (uint64_t done = 0; done < n; done += count)
+                    for (size_t k = 0; k < sched.size(); k++)
+                    {
+                        sched[k]->Cycle(out.data());
+                        acc += out[0].pressure;
+                    }
+                sink = acc;
+            }, (uint64_t)count);
+        }
+    }
+}
+
+
+// Main
+// -----------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+        filter = argv[1];
+    if (argc > 2)
+        minns = atoi(argv[2]) * 1e6;
+
+    printf("{\"bench\":\"meta\",\"arch\":\"%s\",\"simd\":\"%s\",\"compiler\":\"%s\",\"comp\":%d,\"metrics\":%d}\n",
+           Arch(), Simd(), __VERSION__, BMP280_COMP, BMP280_METRICS);
+
+    MockBus bus;
+    BMP280  dev(&bus, 0x76);
+    dev.LoadCalParams();
+
+    CompBenches(dev);
+    QueueBenches();
+    HistoryBenches();
+    DriverBenches(dev);
+    SimBenches();
+
+    return 0;
+}
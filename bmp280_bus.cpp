@@ -0,0 +1,81 @@
+/*
+ * bmp280_bus.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    BeagleBone Black I2C implementation of BMP280Bus.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <stdint.h>          // uint8_t
+
+#include "bmp280_bus.hpp"    // BMP280I2CBus
+
+using namespace std;
+
+#if BMP280_BBBI2C
+
+namespace bosch_bmp280
+{
+
+/*
+ * void BMP280I2CBus::Read(uint8_t addr, uint8_t reg, uint8_t* data, int len)
+ *
+ * Description:
+ *   Reads len consecutive registers: writes the start register
+ *   address, then reads, in one combined I2C transfer.
+ *
+ * Parameters:
+ *   addr - I2C address of the device
+ *   reg  - address of the first register to be read
+ *   data - receives len bytes
+ *   len  - the number of bytes to read
+ *
+ * Exceptions:
+ *   Whatever I2CBus::Xfer() throws.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_bus.hpp
+ */
+void BMP280I2CBus::Read(uint8_t addr, uint8_t reg, uint8_t* data, int len)
+{
+    i2cbus->Xfer(&reg, 1, data, len, addr);
+}
+
+/*
+ * void BMP280I2CBus::Write(uint8_t addr, uint8_t* data, int len)
+ *
+ * Description:
+ *   Writes {register, value} pairs in one I2C write.
+ *
+ * Parameters:
+ *   addr - I2C address of the device
+ *   data - the pairs
+ *   len  - the total number of bytes
+ *
+ * Exceptions:
+ *   Whatever I2CBus::Write() throws.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_bus.hpp
+ */
+void BMP280I2CBus::Write(uint8_t addr, uint8_t* data, int len)
+{
+    i2cbus->Write(data, len, addr);
+}
+
+} // namespace bosch_bmp280
+
+#endif // BMP280_BBBI2C
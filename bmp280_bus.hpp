@@ -0,0 +1,116 @@
+/*
+ * bmp280_bus.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    The register-access interface that BMP280 talks through, and its
+ *    BeagleBone Black I2C implementation.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_BUS_HPP_
+#define BMP280_BUS_HPP_
+
+#include <stdint.h>          // uint8_t
+
+// BeagleBone Black I2C support, through the bbbi2c library. Set to 0
+// to build without it (and without bbb-i2c.hpp): BMP280I2CBus and the
+// I2CBus constructors are left out, and devices are reached through
+// the other BMP280Bus implementations.
+#ifndef BMP280_BBBI2C
+  #define BMP280_BBBI2C  1
+#endif
+
+#if BMP280_BBBI2C
+  #include "bbb-i2c.hpp"     // I2CBus
+#endif
+
+namespace bosch_bmp280
+{
+
+/*
+ * class BMP280Bus
+ *
+ * Description:
+ *   A bus that BMP280 devices sit on. A device is named by its
+ *   address on the bus.
+ *
+ *   Read() reads len consecutive registers, starting at reg.
+ *
+ *   Write() writes {register, value} pairs, len bytes in all, in one
+ *   transaction.
+ *
+ *   Port() identifies the physical bus, so that two BMP280Bus objects
+ *   over the same hardware compare as the same bus. The default is
+ *   the object itself.
+ *
+ *   Errors are reported by exception, as the implementation sees fit.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_bus.hpp
+ */
+class BMP280Bus
+{
+  public:
+
+    virtual ~BMP280Bus () { }
+
+    virtual void  Read  ( uint8_t addr, uint8_t reg, uint8_t* data, int len ) = 0;
+    virtual void  Write ( uint8_t addr, uint8_t* data, int len ) = 0;
+
+    virtual const void*  Port () const { return this; }
+
+}; // class BMP280Bus
+
+
+#if BMP280_BBBI2C
+
+/*
+ * class BMP280I2CBus
+ *
+ * Description:
+ *   BMP280Bus over a BeagleBone Black I2C bus (bbbi2c::I2CBus). The
+ *   I2CBus is not owned, and must outlive this object.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_bus.hpp
+ */
+class BMP280I2CBus : public BMP280Bus
+{
+  protected:
+    bbbi2c::I2CBus*  i2cbus;
+
+  public:
+
+    BMP280I2CBus ( bbbi2c::I2CBus* bus ) : i2cbus(bus) { }
+
+    void  Read  ( uint8_t addr, uint8_t reg, uint8_t* data, int len ) override;
+    void  Write ( uint8_t addr, uint8_t* data, int len ) override;
+
+    const void*  Port () const override { return i2cbus; }
+
+    bbbi2c::I2CBus*  I2C () const { return i2cbus; }
+
+}; // class BMP280I2CBus
+
+#endif // BMP280_BBBI2C
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_BUS_HPP_ */
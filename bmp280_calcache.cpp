@@ -0,0 +1,352 @@
+/*
+ * bmp280_calcache.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    On-disk cache of BMP280 calibration parameters.
+ *
+ *  Notes:
+ *    1. Save() writes a temporary file, fsync()s it, and renames it
+ *       over the cache, so a crash or power loss mid-write leaves the
+ *       old cache intact.
+ *    2. Malformed lines are skipped rather than treated as errors. A
+ *       sensor whose line is lost is simply read from the bus again.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <cctype>              // isspace(), isprint()
+#include <cstdio>              // rename(), snprintf()
+#include <fcntl.h>             // open()
+#include <fstream>             // ifstream
+#include <sstream>             // istringstream
+#include <stdexcept>           // runtime_error
+#include <string>              // string, getline()
+#include <unistd.h>            // write(), fsync(), close(), unlink()
+
+#include "bmp280_calcache.hpp" // BMP280CalCache
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+/*
+ * Converts one hex digit. Returns -1 if c is not a hex digit.
+ */
+static int HexDigit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/*
+ * Throws unless busid can be written as one field of a cache line:
+ * not empty, and no whitespace or control characters.
+ */
+static void CheckBusId(const string& busid, const char* func)
+{
+    bool ok = !busid.empty();
+
+    for (size_t i = 0; i < busid.size() && ok; i++)
+    {
+        unsigned char c = (unsigned char)busid[i];
+        ok = (c >= 0x80) || (isprint(c) && !isspace(c));
+    }
+
+    if (!ok)
+    {
+        runtime_error re {string("BMP280CalCache::") + func + "(): Bus id must be one word."};
+        throw re;
+    }
+}
+
+/*
+ * Writes all of data to fd. Returns false on error.
+ */
+static bool WriteAll(int fd, const string& data)
+{
+    size_t done = 0;
+
+    while (done < data.size())
+    {
+        ssize_t n = write(fd, data.data() + done, data.size() - done);
+        if (n < 0)
+            return false;
+        done += (size_t)n;
+    }
+
+    return true;
+}
+
+
+// BMP280CalCache Constructor
+// -----------------------------------------------------------------
+
+/*
+ * BMP280CalCache::BMP280CalCache(const string& file)
+ *
+ * Description:
+ *   Constructor. The cache starts out empty: call Load() to read the
+ *   file.
+ *
+ * Parameters:
+ *   file - path of the cache file
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_calcache.hpp
+ */
+BMP280CalCache::BMP280CalCache(const string& file)
+{
+    path  = file;
+    dirty = false;
+}
+
+
+// BMP280CalCache Public
+// -----------------------------------------------------------------
+
+/*
+ * int BMP280CalCache::Load()
+ *
+ * Description:
+ *   Reads the cache file, replacing any entries already held. A
+ *   missing file is an empty cache.
+ *
+ * Returns:
+ *   Returns the number of entries loaded.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_calcache.hpp
+ */
+int BMP280CalCache::Load()
+{
+    entries.clear();
+    dirty = false;
+
+    ifstream in(path);
+    string   line;
+
+    while (getline(in, line))
+    {
+        istringstream fields(line);
+        string   busid, rom;
+        unsigned addr, chipid, crc;
+
+        if (!(fields >> busid >> hex >> addr >> chipid >> rom >> crc))
+            continue;
+        if (addr > 0xFF || chipid > 0xFF || rom.size() != 2*BMP280_CAL_SIZE)
+            continue;
+
+        Entry e;
+        bool  ok = true;
+        for (int i = 0; i < BMP280_CAL_SIZE && ok; i++)
+        {
+            int hi = HexDigit(rom[2*i]);
+            int lo = HexDigit(rom[2*i + 1]);
+            ok = (hi >= 0 && lo >= 0);
+            e.rom[i] = (uint8_t)((hi << 4) | lo);
+        }
+        if (!ok || Crc32(e.rom, BMP280_CAL_SIZE) != crc)
+            continue;
+
+        entries[Key(busid, (uint8_t)addr, (uint8_t)chipid)] = e;
+    }
+
+    return (int)entries.size();
+}
+
+/*
+ * void BMP280CalCache::Save()
+ *
+ * Description:
+ *   Writes every entry to the cache file.
+ *
+ * Exceptions:
+ *   Throws runtime_error if the file cannot be written.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_calcache.hpp
+ */
+void BMP280CalCache::Save()
+{
+    string tmp = path + ".tmp";
+    string out;
+
+    for (map<Key,Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    {
+        char rom[2*BMP280_CAL_SIZE + 1];
+        char tail[32];
+
+        for (int i = 0; i < BMP280_CAL_SIZE; i++)
+            snprintf(rom + 2*i, 3, "%02x", it->second.rom[i]);
+        snprintf(tail, sizeof(tail), " %08x\n", (unsigned)Crc32(it->second.rom, BMP280_CAL_SIZE));
+
+        char key[16];
+        snprintf(key, sizeof(key), " %02x %02x ",
+                 (unsigned)get<1>(it->first), (unsigned)get<2>(it->first));
+
+        out += get<0>(it->first);
+        out += key;
+        out += rom;
+        out += tail;
+    }
+
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        runtime_error re {"BMP280CalCache::Save(): Cannot write cache file."};
+        throw re;
+    }
+
+    bool ok = WriteAll(fd, out) && fsync(fd) == 0;
+    if (close(fd) != 0 || !ok)
+    {
+        unlink(tmp.c_str());
+        runtime_error re {"BMP280CalCache::Save(): Cannot write cache file."};
+        throw re;
+    }
+
+    if (rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        runtime_error re {"BMP280CalCache::Save(): Cannot replace cache file."};
+        throw re;
+    }
+
+    dirty = false;
+}
+
+/*
+ * bool BMP280CalCache::Restore(BMP280& dev, const string& busid,
+ *                              uint8_t chipid, bool verify)
+ *
+ * Description:
+ *   Installs the cached calibration for a device, if there is one.
+ *   Otherwise reads the calibration from the device and adds it to
+ *   the cache.
+ *
+ * Parameters:
+ *   dev    - the device
+ *   busid  - name of the bus the device is on
+ *   chipid - optional. The device's chip id, if it has been probed.
+ *            The default is BMP280_ID.
+ *   verify - optional. If true, a cached image is checked against
+ *            the device ROM, and replaced if it does not match. This
+ *            costs the same bus read the cache is meant to save. The
+ *            default is false.
+ *
+ * Returns:
+ *   Returns true if the cached image was used.
+ *
+ * Exceptions:
+ *   Throws runtime_error if busid is empty or contains whitespace,
+ *   since it could not be saved and loaded back.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_calcache.hpp
+ */
+bool BMP280CalCache::Restore(BMP280& dev, const string& busid, uint8_t chipid, bool verify)
+{
+    CheckBusId(busid, "Restore");
+
+    map<Key,Entry>::const_iterator it = entries.find(Key(busid, dev.Address(), chipid));
+
+    if (it != entries.end())
+    {
+        dev.SetCalRaw(it->second.rom);
+        if (!verify || dev.VerifyCalParams())
+            return true;
+
+        dev.LoadCalParams();
+    }
+
+    this->Store(dev, busid, chipid);
+    return false;
+}
+
+/*
+ * void BMP280CalCache::Store(BMP280& dev, const string& busid, uint8_t chipid)
+ *
+ * Description:
+ *   Adds a device's calibration to the cache, or replaces it. The
+ *   calibration is read from the device, if it has not been already.
+ *
+ * Parameters:
+ *   dev    - the device
+ *   busid  - name of the bus the device is on
+ *   chipid - optional. The device's chip id. The default is BMP280_ID.
+ *
+ * Exceptions:
+ *   Throws runtime_error if busid is empty or contains whitespace.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_calcache.hpp
+ */
+void BMP280CalCache::Store(BMP280& dev, const string& busid, uint8_t chipid)
+{
+    CheckBusId(busid, "Store");
+
+    Entry e;
+    dev.GetCalRaw(e.rom);
+
+    entries[Key(busid, dev.Address(), chipid)] = e;
+    dirty = true;
+}
+
+/*
+ * uint32_t BMP280CalCache::Crc32(const uint8_t* data, int len)
+ *
+ * Description:
+ *   CRC-32 (IEEE 802.3, reflected, as used by zlib). Bitwise, since
+ *   it only ever sees 24 bytes at a time.
+ *
+ * Parameters:
+ *   data - pointer to the first byte
+ *   len  - the number of bytes
+ *
+ * Returns:
+ *   Returns the CRC.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_calcache.hpp
+ */
+uint32_t BMP280CalCache::Crc32(const uint8_t* data, int len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (int i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+
+    return ~crc;
+}
+
+} // namespace bosch_bmp280
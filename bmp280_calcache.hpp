@@ -0,0 +1,100 @@
+/*
+ * bmp280_calcache.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    On-disk cache of BMP280 calibration parameters, so that a cold
+ *    start of many sensors does not have to read every calibration
+ *    ROM over the bus.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_CALCACHE_HPP_
+#define BMP280_CALCACHE_HPP_
+
+#include <map>               // map
+#include <stdint.h>          // uint8_t, uint32_t
+#include <string>            // string
+#include <tuple>             // tuple
+
+#include "bmp280.hpp"        // BMP280
+
+namespace bosch_bmp280
+{
+
+/*
+ * class BMP280CalCache
+ *
+ * Description:
+ *   A small text file of calibration ROM images, one line per device:
+ *
+ *     <bus id> <address> <chip id> <48 hex digits of ROM> <crc32>
+ *
+ *   The bus id is whatever string the caller uses to name the bus
+ *   (its device node, typically), as long as it is one word: ids
+ *   with whitespace are refused. Together with the address and chip
+ *   id it identifies a sensor.
+ *
+ *   Restore() installs a cached image with BMP280::SetCalRaw(), so
+ *   the first reading does not pay for a 24-byte burst read. On a
+ *   miss it reads the device and remembers the result; Save() then
+ *   writes the file back.
+ *
+ *   Each line carries a CRC-32 of its ROM image, and lines that fail
+ *   it are dropped on Load(). Restore() can also re-read the device
+ *   to verify a cached image (see BMP280::VerifyCalParams()), for
+ *   when a sensor may have been swapped at the same address.
+ *
+ *   Not thread-safe. Restore the sensors from one thread at startup.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_calcache.hpp
+ */
+class BMP280CalCache
+{
+  protected:
+    typedef std::tuple<std::string, uint8_t, uint8_t> Key;  // bus id, address, chip id
+
+    struct Entry
+    {
+        uint8_t rom[BMP280_CAL_SIZE];
+    };
+
+    std::string         path;
+    std::map<Key,Entry> entries;
+    bool                dirty;
+
+  public:
+
+    BMP280CalCache ( const std::string& file );
+
+    int   Load ();
+    void  Save ();
+
+    bool  Restore ( BMP280& dev, const std::string& busid,
+                    uint8_t chipid=BMP280_ID, bool verify=false );
+    void  Store   ( BMP280& dev, const std::string& busid, uint8_t chipid=BMP280_ID );
+
+    bool    Dirty () const { return dirty; }
+    size_t  size  () const { return entries.size(); }
+
+    static uint32_t  Crc32 ( const uint8_t* data, int len );
+
+}; // class BMP280CalCache
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_CALCACHE_HPP_ */
@@ -0,0 +1,291 @@
+/*
+ * bmp280_channel.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Lock-free channels for handing BMP280 readings from an acquisition
+ *    thread to consumer threads without a mutex.
+ *
+ *  Memory Ordering:
+ *    1. A producer writes the element first, then publishes it with a
+ *       release store (SPSCChannel: tail; MPSCChannel: the cell's
+ *       sequence number).
+ *    2. The consumer observes the publication with an acquire load
+ *       before reading the element, so it always sees the complete
+ *       element that was written.
+ *    3. The consumer releases a slot back to producers with a release
+ *       store after it has finished reading the element. Producers
+ *       acquire that store before writing the slot again, so a slot is
+ *       never overwritten while it is being read.
+ *    4. Nothing else is ordered. In particular, elements pushed by
+ *       different MPSCChannel producers have no defined order
+ *       relative to each other, apart from the order in which they
+ *       won their slots.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_CHANNEL_HPP_
+#define BMP280_CHANNEL_HPP_
+
+#include <atomic>            // atomic
+#include <cstddef>           // size_t
+#include <stdint.h>          // intptr_t
+#include <vector>            // vector
+
+#include "bmp280_data.hpp"   // TP32Data
+
+namespace bosch_bmp280
+{
+
+// Assumed cache line size. Keeps producer and consumer indexes
+// from sharing a line.
+#define BMP280_CACHE_LINE  64
+
+
+/*
+ * size_t ChannelSize(size_t capacity)
+ *
+ * Description:
+ *   Rounds a requested channel capacity up to a power of two
+ *   (minimum 2), so that slot indexes can be masked instead of
+ *   divided.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_channel.hpp
+ */
+inline size_t ChannelSize(size_t capacity)
+{
+    size_t n = 2;
+    while (n < capacity)
+        n <<= 1;
+    return n;
+}
+
+
+/*
+ * template<typename T> class SPSCChannel
+ *
+ * Description:
+ *   A bounded, wait-free channel for exactly one producer thread and
+ *   exactly one consumer thread.
+ *
+ *   push() and pop() never block and never allocate. push() returns
+ *   false if the channel is full, pop() returns false if it is empty,
+ *   and the caller decides whether to drop, retry or do something
+ *   else.
+ *
+ *   Each side keeps a private copy of the other side's index and only
+ *   reloads it when the copy says the channel is full (or empty), so
+ *   in steady state each operation touches one shared cache line.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_channel.hpp
+ */
+template<typename T>
+class SPSCChannel
+{
+  protected:
+    std::vector<T> slots;
+    size_t mask;
+
+    // Consumer side.
+    std::atomic<size_t> head;
+    size_t tailcache;
+    char   pad1[BMP280_CACHE_LINE];
+
+    // Producer side.
+    std::atomic<size_t> tail;
+    size_t headcache;
+    char   pad2[BMP280_CACHE_LINE];
+
+  public:
+
+    SPSCChannel ( size_t capacity )
+        : slots(ChannelSize(capacity)), mask(ChannelSize(capacity) - 1),
+          head(0), tailcache(0), tail(0), headcache(0)
+    { }
+
+    SPSCChannel ( const SPSCChannel& ) = delete;
+    SPSCChannel& operator= ( const SPSCChannel& ) = delete;
+
+    size_t capacity () const { return mask + 1; }
+
+    // Producer only.
+    bool push ( const T& item )
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+
+        if (t - headcache > mask)
+        {
+            headcache = head.load(std::memory_order_acquire);
+            if (t - headcache > mask)
+                return false;
+        }
+
+        slots[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Consumer only.
+    bool pop ( T& item )
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+
+        if (h == tailcache)
+        {
+            tailcache = tail.load(std::memory_order_acquire);
+            if (h == tailcache)
+                return false;
+        }
+
+        item = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Either side. The result is only a snapshot.
+    size_t size () const
+    {
+        size_t t = tail.load(std::memory_order_acquire);
+        size_t h = head.load(std::memory_order_acquire);
+        return t - h;
+    }
+
+}; // class SPSCChannel
+
+
+/*
+ * template<typename T> class MPSCChannel
+ *
+ * Description:
+ *   A bounded channel for any number of producer threads and exactly
+ *   one consumer thread. Intended for aggregating readings from
+ *   several sensors, each sampled on its own thread.
+ *
+ *   Every slot carries a sequence number that says whose turn it is:
+ *   a producer may fill slot i when its sequence equals the ticket i,
+ *   and the consumer may read it when its sequence equals i + 1.
+ *   Producers claim tickets with a compare-and-swap, so push() is
+ *   lock-free (some producer always makes progress), and pop() is
+ *   wait-free.
+ *
+ *   push() returns false if the channel is full, pop() returns false
+ *   if it is empty. Neither blocks nor allocates.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_channel.hpp
+ */
+template<typename T>
+class MPSCChannel
+{
+  protected:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T item;
+    };
+
+    std::vector<Cell> cells;
+    size_t mask;
+    char   pad0[BMP280_CACHE_LINE];
+
+    std::atomic<size_t> tail;        // next producer ticket
+    char   pad1[BMP280_CACHE_LINE];
+
+    size_t head;                     // consumer only
+    char   pad2[BMP280_CACHE_LINE];
+
+  public:
+
+    MPSCChannel ( size_t capacity )
+        : cells(ChannelSize(capacity)), mask(ChannelSize(capacity) - 1),
+          tail(0), head(0)
+    {
+        for (size_t i = 0; i <= mask; i++)
+            cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MPSCChannel ( const MPSCChannel& ) = delete;
+    MPSCChannel& operator= ( const MPSCChannel& ) = delete;
+
+    size_t capacity () const { return mask + 1; }
+
+    // Any producer.
+    bool push ( const T& item )
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Cell&  c   = cells[t & mask];
+            size_t seq = c.seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)t;
+
+            if (dif == 0)
+            {
+                if (tail.compare_exchange_weak(t, t + 1, std::memory_order_relaxed))
+                {
+                    c.item = item;
+                    c.seq.store(t + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (dif < 0)
+            {
+                return false;        // full
+            }
+            else
+            {
+                t = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only.
+    bool pop ( T& item )
+    {
+        Cell&  c   = cells[head & mask];
+        size_t seq = c.seq.load(std::memory_order_acquire);
+
+        if (seq != head + 1)
+            return false;            // empty, or a producer is mid-write
+
+        item = c.item;
+        c.seq.store(head + mask + 1, std::memory_order_release);
+        head++;
+
+        return true;
+    }
+
+}; // class MPSCChannel
+
+
+// Channels of TP32Data readings.
+typedef SPSCChannel<TP32Data>  TP32Channel;
+typedef MPSCChannel<TP32Data>  TP32MultiChannel;
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_CHANNEL_HPP_ */
@@ -1,4 +1,3 @@
-```
 /*
  * bmp280_comp.cpp
  *
@@ -13,6 +12,10 @@
  *    2. In the compensation functions, I picked the action apart into a ton of
  *       local variables just to get a feel for what is going on. Feel free to
  *       reverse this, if you like.
+ *    3. The Cal32Fixed kernels at the bottom of this file are the same
+ *       formulas with the constant parts folded into the compiled
+ *       coefficients. The BMP280 member functions are kept as the
+ *       reference implementation.
  *
  *  And Another Thing:
  *    JSRagman is not associated in any way with the good people at
@@ -21,6 +24,7 @@
  */
 
 #include "bmp280.hpp"
+#include "bmp280_comp.hpp"   // Cal32Fixed
 
 namespace bosch_bmp280
 {
@@ -46,6 +50,9 @@ namespace bosch_bmp280
  *   tfine - When this function exits, tfine will contain a value that
  *   can be used to compensate an associated pressure reading.
  *
+ *   Because of tfine, this is not reentrant. See Comp32Fixed() for
+ *   compensation that can run on several threads.
+ *
  * Namespace:
  *   bosch_bmp280
  *
@@ -149,5 +156,522 @@ uint32_t BMP280::Comp32FixedPress(uint32_t uncpress)
     return pressure;
 }
 
+
+// Cal32Fixed
+// -----------------------------------------------------------------
+
+/*
+ * Cal32Fixed::Cal32Fixed()
+ *
+ * Description:
+ *   Constructor. Compiles an all-zero set of calibration parameters.
+ *   Pressure compensation returns zero until real parameters are
+ *   compiled.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+Cal32Fixed::Cal32Fixed() : Cal32Fixed(CalParams())
+{ }
+
+/*
+ * Cal32Fixed::Cal32Fixed(const CalParams& cp)
+ *
+ * Description:
+ *   Constructor. Widens the calibration parameters and pre-computes
+ *   the constant terms of the compensation formulas.
+ *
+ * Parameters:
+ *   cp - calibration parameters, as loaded from the device ROM
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+Cal32Fixed::Cal32Fixed(const CalParams& cp)
+{
+    t1    = (int32_t)cp.t1;
+    t1x2  = t1 << 1;
+    t2    = (int32_t)cp.t2;
+    t3    = (int32_t)cp.t3;
+
+    p1    = (int32_t)cp.p1;
+    p2    = (int32_t)cp.p2;
+    p3    = (int32_t)cp.p3;
+    p4s16 = (int32_t)cp.p4 * 65536;
+    p5x2  = (int32_t)cp.p5 * 2;
+    p6    = (int32_t)cp.p6;
+    p7    = (int32_t)cp.p7;
+    p8    = (int32_t)cp.p8;
+    p9    = (int32_t)cp.p9;
+}
+
+/*
+ * int32_t Cal32Fixed::Temp(int32_t unctemp, int32_t& tfine) const
+ *
+ * Description:
+ *   32-bit fixed-point temperature compensation kernel. Same result
+ *   as BMP280::Comp32FixedTemp().
+ *
+ * Parameters:
+ *   unctemp - an uncompensated temperature reading
+ *   tfine   - receives the fine temperature value needed to
+ *             compensate the associated pressure reading
+ *
+ * Returns:
+ *   Returns temperature in 1/100 degrees centigrade.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+int32_t Cal32Fixed::Temp(int32_t unctemp, int32_t& tfine) const
+{
+    int32_t d  = (unctemp >> 4) - t1;
+    int32_t v1 = (((unctemp >> 3) - t1x2) * t2) >> 11;
+    int32_t v2 = (((d * d) >> 12) * t3) >> 14;
+
+    tfine = v1 + v2;
+
+    return (5*tfine + 128) >> 8;
+}
+
+/*
+ * uint32_t Cal32Fixed::Press(uint32_t uncpress, int32_t tfine) const
+ *
+ * Description:
+ *   32-bit fixed-point pressure compensation kernel. Same result as
+ *   BMP280::Comp32FixedPress().
+ *
+ * Parameters:
+ *   uncpress - an uncompensated pressure reading
+ *   tfine    - fine temperature from the associated temperature
+ *              reading (see Temp())
+ *
+ * Returns:
+ *   Returns pressure in pascals (Pa), or zero if the parameters would
+ *   cause a division by zero.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+uint32_t Cal32Fixed::Press(uint32_t uncpress, int32_t tfine) const
+{
+    int32_t v1  = (tfine >> 1) - 64000;
+    int32_t v1a = (v1 >> 2)*(v1 >> 2);
+    int32_t v2  = (((v1a >> 11)*p6 + v1*p5x2) >> 2) + p4s16;
+
+    v1 = (((p3*(v1a >> 13)) >> 3) + ((p2*v1) >> 1)) >> 18;
+    v1 = ((32768 + v1)*p1) >> 15;
+    if (v1 == 0)
+        return 0;
+
+    uint32_t v3 = ((uint32_t)(1048576 - uncpress) - (v2 >> 12)) * 3125;
+    v3 = (v3 < 0x80000000) ? (v3 << 1)/(uint32_t)v1 : (v3/(uint32_t)v1)*2;
+
+    uint32_t v3a = (v3 >> 3)*(v3 >> 3);
+    int32_t  w1  = (p9 * (int32_t)(v3a >> 13)) >> 12;
+    int32_t  w2  = (((int32_t)(v3 >> 2)) * p8) >> 13;
+
+    return (uint32_t)( (int32_t)v3 + ((w1 + w2 + p7) >> 4) );
+}
+
+/*
+ * TP32Data Cal32Fixed::Compensate(const TP32Data& raw) const
+ *
+ * Description:
+ *   Compensates one raw reading. Reentrant.
+ *
+ * Parameters:
+ *   raw - uncompensated temperature and pressure
+ *
+ * Returns:
+ *   Returns temperature in 1/100 degrees centigrade and pressure in
+ *   pascals, with the time stamp of raw.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+TP32Data Cal32Fixed::Compensate(const TP32Data& raw) const
+{
+    TP32Data reading = raw;
+    int32_t  tf;
+
+    reading.temperature = this->Temp(raw.temperature, tf);
+    reading.pressure    = this->Press(raw.pressure, tf);
+
+    return reading;
+}
+
+
+// Cal64Fixed
+// -----------------------------------------------------------------
+
+/*
+ * Cal64Fixed::Cal64Fixed()
+ *
+ * Description:
+ *   Constructor. Compiles an all-zero set of calibration parameters.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+Cal64Fixed::Cal64Fixed() : Cal64Fixed(CalParams())
+{ }
+
+/*
+ * Cal64Fixed::Cal64Fixed(const CalParams& cp)
+ *
+ * Description:
+ *   Constructor. Widens the pressure parameters to 64 bits and
+ *   pre-computes p4 << 35 and p7 << 4.
+ *
+ * Parameters:
+ *   cp - calibration parameters, as loaded from the device ROM
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+Cal64Fixed::Cal64Fixed(const CalParams& cp) : tcal(cp)
+{
+    p1    = (int64_t)cp.p1;
+    p2    = (int64_t)cp.p2;
+    p3    = (int64_t)cp.p3;
+    p4s35 = (int64_t)cp.p4 * ((int64_t)1 << 35);
+    p5    = (int64_t)cp.p5;
+    p6    = (int64_t)cp.p6;
+    p7s4  = (int64_t)cp.p7 * 16;
+    p8    = (int64_t)cp.p8;
+    p9    = (int64_t)cp.p9;
+}
+
+/*
+ * int32_t Cal64Fixed::Temp(int32_t unctemp, int32_t& tfine) const
+ *
+ * Description:
+ *   Temperature compensation. Same as Cal32Fixed::Temp().
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+int32_t Cal64Fixed::Temp(int32_t unctemp, int32_t& tfine) const
+{
+    return tcal.Temp(unctemp, tfine);
+}
+
+/*
+ * uint32_t Cal64Fixed::Press(uint32_t uncpress, int32_t tfine) const
+ *
+ * Description:
+ *   64-bit fixed-point pressure compensation.
+ *
+ *   Compensation formula derived from Bosch datasheet
+ *   BST-BMP280-DS001-19, Revision 1.19, January 2018, section 8.2.
+ *
+ * Parameters:
+ *   uncpress - an uncompensated pressure reading
+ *   tfine    - fine temperature from the associated temperature
+ *              reading (see Temp())
+ *
+ * Returns:
+ *   Returns pressure in Q24.8 format (pascals times 256), or zero if
+ *   the parameters would cause a division by zero.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+uint32_t Cal64Fixed::Press(uint32_t uncpress, int32_t tfine) const
+{
+    int64_t v1 = (int64_t)tfine - 128000;
+    int64_t v2 = v1*v1*p6 + (v1*p5)*131072 + p4s35;
+
+    v1 = ((v1*v1*p3) >> 8) + (v1*p2)*4096;
+    v1 = ((((int64_t)1 << 47) + v1)*p1) >> 33;
+    if (v1 == 0)
+        return 0;
+
+    int64_t p = 1048576 - (int64_t)uncpress;
+    p = ((p*2147483648LL - v2)*3125) / v1;
+
+    v1 = (p9 * (p >> 13) * (p >> 13)) >> 25;
+    v2 = (p8 * p) >> 19;
+
+    return (uint32_t)( ((p + v1 + v2) >> 8) + p7s4 );
+}
+
+/*
+ * TP32Data Cal64Fixed::Compensate(const TP32Data& raw) const
+ *
+ * Description:
+ *   Compensates one raw reading. Reentrant.
+ *
+ * Parameters:
+ *   raw - uncompensated temperature and pressure
+ *
+ * Returns:
+ *   Returns temperature in 1/100 degrees centigrade and pressure in
+ *   Q24.8 pascals, with the time stamp of raw.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+TP32Data Cal64Fixed::Compensate(const TP32Data& raw) const
+{
+    TP32Data reading = raw;
+    int32_t  tf;
+
+    reading.temperature = this->Temp(raw.temperature, tf);
+    reading.pressure    = this->Press(raw.pressure, tf);
+
+    return reading;
+}
+
+
+// CalDouble
+// -----------------------------------------------------------------
+
+/*
+ * CalDouble::CalDouble()
+ *
+ * Description:
+ *   Constructor. Compiles an all-zero set of calibration parameters.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+CalDouble::CalDouble() : CalDouble(CalParams())
+{ }
+
+/*
+ * CalDouble::CalDouble(const CalParams& cp)
+ *
+ * Description:
+ *   Constructor. Converts the calibration parameters to doubles,
+ *   with the constant power-of-two factors of the formulas applied.
+ *   Scaling by a power of two is exact, so results are the same as
+ *   those of the formulas as written.
+ *
+ * Parameters:
+ *   cp - calibration parameters, as loaded from the device ROM
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+CalDouble::CalDouble(const CalParams& cp)
+{
+    t1k  = (double)cp.t1 / 1024.0;
+    t1k8 = (double)cp.t1 / 8192.0;
+    t2   = (double)cp.t2;
+    t3   = (double)cp.t3;
+
+    p1 = (double)cp.p1;
+    p2 = (double)cp.p2 / 524288.0;
+    p3 = (double)cp.p3 / 524288.0 / 524288.0;
+    p4 = (double)cp.p4 * 65536.0;
+    p5 = (double)cp.p5 * 2.0;
+    p6 = (double)cp.p6 / 32768.0;
+    p7 = (double)cp.p7;
+    p8 = (double)cp.p8 / 32768.0;
+    p9 = (double)cp.p9 / 2147483648.0;
+}
+
+/*
+ * double CalDouble::Temp(int32_t unctemp, int32_t& tfine) const
+ *
+ * Description:
+ *   Double-precision temperature compensation.
+ *
+ *   Compensation formula derived from Bosch datasheet
+ *   BST-BMP280-DS001-19, Revision 1.19, January 2018, section 8.1.
+ *
+ * Parameters:
+ *   unctemp - an uncompensated temperature reading
+ *   tfine   - receives the fine temperature value needed to
+ *             compensate the associated pressure reading
+ *
+ * Returns:
+ *   Returns temperature in degrees centigrade.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+double CalDouble::Temp(int32_t unctemp, int32_t& tfine) const
+{
+    double v1 = ((double)unctemp/16384.0 - t1k) * t2;
+    double d  =  (double)unctemp/131072.0 - t1k8;
+    double v2 = (d * d) * t3;
+
+    tfine = (int32_t)(v1 + v2);
+
+    return (v1 + v2) / 5120.0;
+}
+
+/*
+ * double CalDouble::Press(uint32_t uncpress, int32_t tfine) const
+ *
+ * Description:
+ *   Double-precision pressure compensation.
+ *
+ *   Compensation formula derived from Bosch datasheet
+ *   BST-BMP280-DS001-19, Revision 1.19, January 2018, section 8.1.
+ *
+ * Parameters:
+ *   uncpress - an uncompensated pressure reading
+ *   tfine    - fine temperature from the associated temperature
+ *              reading (see Temp())
+ *
+ * Returns:
+ *   Returns pressure in pascals, or zero if the parameters would
+ *   cause a division by zero.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+double CalDouble::Press(uint32_t uncpress, int32_t tfine) const
+{
+    double v1 = (double)tfine/2.0 - 64000.0;
+    double v2 = v1 * v1 * p6;
+
+    v2 = v2 + v1 * p5;
+    v2 = v2/4.0 + p4;
+    v1 = p3 * v1 * v1 + p2 * v1;
+    v1 = (1.0 + v1/32768.0) * p1;
+    if (v1 == 0.0)
+        return 0.0;
+
+    double p = 1048576.0 - (double)uncpress;
+    p  = (p - v2/4096.0) * 6250.0 / v1;
+    v1 = p9 * p * p;
+    v2 = p * p8;
+
+    return p + (v1 + v2 + p7)/16.0;
+}
+
+/*
+ * TPDoubleData CalDouble::Compensate(const TP32Data& raw) const
+ *
+ * Description:
+ *   Compensates one raw reading. Reentrant.
+ *
+ * Parameters:
+ *   raw - uncompensated temperature and pressure
+ *
+ * Returns:
+ *   Returns temperature in degrees centigrade and pressure in
+ *   pascals, with the time stamp of raw.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+TPDoubleData CalDouble::Compensate(const TP32Data& raw) const
+{
+    TPDoubleData reading;
+    int32_t      tf;
+
+    reading.timestamp   = raw.timestamp;
+    reading.monotime    = raw.monotime;
+    reading.temperature = this->Temp(raw.temperature, tf);
+    reading.pressure    = this->Press(raw.pressure, tf);
+
+    return reading;
+}
+
+
+// Pure Compensation
+// -----------------------------------------------------------------
+
+/*
+ * TP32Data Comp32Fixed(const Cal32Fixed& cal, const TP32Data& raw)
+ *
+ * Description:
+ *   Applies 32-bit fixed-point compensation to one raw reading.
+ *   Reentrant: t_fine is kept in a local.
+ *
+ * Parameters:
+ *   cal - compiled calibration parameters
+ *   raw - uncompensated temperature and pressure
+ *
+ * Returns:
+ *   Returns the compensated reading, with the time stamp of raw.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+TP32Data Comp32Fixed(const Cal32Fixed& cal, const TP32Data& raw)
+{
+    return cal.Compensate(raw);
+}
+
+/*
+ * void Comp32Fixed(const Cal32Fixed& cal, const TP32Data* raw,
+ *                  TP32Data* out, size_t count)
+ *
+ * Description:
+ *   Applies 32-bit fixed-point compensation to an array of raw
+ *   readings. Reentrant. raw and out may be the same array.
+ *
+ * Parameters:
+ *   cal   - compiled calibration parameters
+ *   raw   - uncompensated readings
+ *   out   - receives the compensated readings
+ *   count - the number of readings
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_comp.hpp
+ */
+void Comp32Fixed(const Cal32Fixed& cal, const TP32Data* raw, TP32Data* out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = Comp32Fixed(cal, raw[i]);
+}
+
 } // namespace bosch_bmp280
-```
\ No newline at end of file
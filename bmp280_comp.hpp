@@ -0,0 +1,201 @@
+/*
+ * bmp280_comp.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Compensation support for the Bosch Sensortec BMP280 Digital
+ *    Pressure Sensor.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_COMP_HPP_
+#define BMP280_COMP_HPP_
+
+#include <cstddef>           // size_t
+#include <stdint.h>          // int32_t, uint32_t, int64_t
+
+#include "bmp280_data.hpp"   // CalParams, TP32Data, TPDoubleData
+
+namespace bosch_bmp280
+{
+
+/*
+ * Compensation Policies
+ *
+ *   Cal32Fixed, Cal64Fixed and CalDouble are interchangeable. Each is
+ *   built once from a CalParams, and each provides:
+ *
+ *     typedef ... Data;                          result type
+ *     Data Compensate(const TP32Data& raw) const;
+ *
+ *   along with Temp() and Press() kernels. Code written against the
+ *   policy as a template parameter (see BMP280::GetCompData()) is
+ *   compiled for exactly one kernel, without runtime dispatch.
+ *
+ *   BMP280_COMP selects the deployment default, CalDefault:
+ *     BMP280_COMP_32FIXED  32-bit fixed point, Pa        (default)
+ *     BMP280_COMP_64FIXED  64-bit fixed point, Pa Q24.8
+ *     BMP280_COMP_DOUBLE   double precision, degC and Pa
+ */
+#define BMP280_COMP_32FIXED  0
+#define BMP280_COMP_64FIXED  1
+#define BMP280_COMP_DOUBLE   2
+
+#ifndef BMP280_COMP
+  #define BMP280_COMP  BMP280_COMP_32FIXED
+#endif
+
+/*
+ * struct Cal32Fixed
+ *
+ * Description:
+ *   Calibration parameters compiled for the 32-bit fixed-point
+ *   compensation formulas.
+ *
+ *   Built once from a CalParams, after which every coefficient is
+ *   already widened to 32 bits, and the constant parts of the Bosch
+ *   formulas (t1 << 1, p4 << 16, p5 << 1) are already done. The
+ *   Temp() and Press() kernels then do only the per-sample
+ *   arithmetic, and give results identical to BMP280::Comp32FixedTemp()
+ *   and BMP280::Comp32FixedPress().
+ *
+ *   The kernels do not touch any shared state: t_fine is passed in
+ *   and out explicitly.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_comp.hpp
+ */
+struct Cal32Fixed
+{
+    typedef TP32Data Data;
+
+    int32_t  t1, t1x2, t2, t3;
+    int32_t  p1, p2, p3, p4s16, p5x2, p6, p7, p8, p9;
+
+    Cal32Fixed ();
+    Cal32Fixed ( const CalParams& cp );
+
+     int32_t  Temp  (  int32_t unctemp,  int32_t& tfine ) const;
+    uint32_t  Press ( uint32_t uncpress, int32_t  tfine ) const;
+
+    TP32Data  Compensate ( const TP32Data& raw ) const;
+};
+
+/*
+ * struct Cal64Fixed
+ *
+ * Description:
+ *   Calibration parameters compiled for the Bosch 64-bit integer
+ *   pressure formula. Temperature is the 32-bit fixed-point result.
+ *
+ *   Pressure comes back as an unsigned Q24.8 value: pascals times
+ *   256. Divide by 256 to get pascals with 1/256 Pa resolution.
+ *
+ *   Faster than Cal32Fixed on 64-bit hosts, where the formula is a
+ *   handful of native multiplies and one 64-bit divide.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_comp.hpp
+ */
+struct Cal64Fixed
+{
+    typedef TP32Data Data;
+
+    Cal32Fixed  tcal;
+    int64_t     p1, p2, p3, p4s35, p5, p6, p7s4, p8, p9;
+
+    Cal64Fixed ();
+    Cal64Fixed ( const CalParams& cp );
+
+     int32_t  Temp  (  int32_t unctemp,  int32_t& tfine ) const;
+    uint32_t  Press ( uint32_t uncpress, int32_t  tfine ) const;
+
+    TP32Data  Compensate ( const TP32Data& raw ) const;
+};
+
+/*
+ * struct CalDouble
+ *
+ * Description:
+ *   Calibration parameters compiled for the Bosch double-precision
+ *   formulas. The power-of-two divisors in the formulas are folded
+ *   into the coefficients, which is exact.
+ *
+ *   Temperature comes back in degrees centigrade, pressure in
+ *   pascals.
+ *
+ *   The best choice on hosts with a fast FPU, and the most precise.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_comp.hpp
+ */
+struct CalDouble
+{
+    typedef TPDoubleData Data;
+
+    double  t1k, t1k8, t2, t3;
+    double  p1, p2, p3, p4, p5, p6, p7, p8, p9;
+
+    CalDouble ();
+    CalDouble ( const CalParams& cp );
+
+    double  Temp  (  int32_t unctemp,  int32_t& tfine ) const;
+    double  Press ( uint32_t uncpress, int32_t  tfine ) const;
+
+    TPDoubleData  Compensate ( const TP32Data& raw ) const;
+};
+
+
+// The deployment's choice of compensation policy.
+#if   BMP280_COMP == BMP280_COMP_64FIXED
+  typedef Cal64Fixed  CalDefault;
+#elif BMP280_COMP == BMP280_COMP_DOUBLE
+  typedef CalDouble   CalDefault;
+#else
+  typedef Cal32Fixed  CalDefault;
+#endif
+
+
+/*
+ * Pure compensation functions.
+ *
+ * Description:
+ *   Compensate raw readings using nothing but the arguments. No
+ *   device, no bus and no shared t_fine are involved, so any number
+ *   of threads may compensate recorded raw data at once, in any
+ *   order, with the same Cal32Fixed.
+ *
+ *   Get the calibration from BMP280::Calibration() once, on the
+ *   acquisition thread, and hand copies to the workers.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_comp.hpp
+ */
+TP32Data  Comp32Fixed ( const Cal32Fixed& cal, const TP32Data& raw );
+void      Comp32Fixed ( const Cal32Fixed& cal, const TP32Data* raw, TP32Data* out, size_t count );
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_COMP_HPP_ */
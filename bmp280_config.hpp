@@ -0,0 +1,227 @@
+/*
+ * bmp280_config.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Typed, constexpr configuration for the Bosch Sensortec BMP280
+ *    Digital Pressure Sensor.
+ *
+ *  Notes:
+ *    1. Everything here can be evaluated at compile time. A
+ *       configuration written as a constexpr gets its register bytes,
+ *       conversion time and output data rate computed by the compiler:
+ *
+ *         constexpr BMP280Config cfg { Osrs::X2, Osrs::X16, Mode::Normal,
+ *                                      Standby::Ms62_5, Filter::X4 };
+ *         static_assert(cfg.Valid(), "bad BMP280 configuration");
+ *         dev.SetConfig(cfg.Ctrl(), cfg.Conf());
+ *
+ *    2. Checked() does the same validation, and fails the build when
+ *       used in a constant expression, or throws at run time.
+ *    3. The datasheet presets are in BMP280Presets[], checked against
+ *       the BMP280_CTRL_PREn/BMP280_CONF_PREn macros in bmp280_defs.hpp.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_CONFIG_HPP_
+#define BMP280_CONFIG_HPP_
+
+#include <stdexcept>         // runtime_error
+#include <stdint.h>          // uint8_t
+
+#include "bmp280_defs.hpp"
+
+namespace bosch_bmp280
+{
+
+// Oversampling, osrs_t and osrs_p.
+enum class Osrs : uint8_t
+{
+    Skip = 0, X1 = 1, X2 = 2, X4 = 3, X8 = 4, X16 = 5
+};
+
+// Power mode. The device also reads 0x02 as forced.
+enum class Mode : uint8_t
+{
+    Sleep = 0, Forced = 1, Normal = 3
+};
+
+// Normal-mode standby time, t_sb.
+enum class Standby : uint8_t
+{
+    Ms0_5 = 0, Ms62_5 = 1, Ms125 = 2, Ms250 = 3, Ms500 = 4, Ms1000 = 5, Ms2000 = 6, Ms4000 = 7
+};
+
+// IIR filter coefficient.
+enum class Filter : uint8_t
+{
+    Off = 0, X2 = 1, X4 = 2, X8 = 3, X16 = 4
+};
+
+
+/*
+ * constexpr int OsrsSamples(Osrs osrs)
+ *
+ * Description:
+ *   The number of samples taken for an oversampling setting. The
+ *   register values above X16 also mean 16 samples.
+ *
+ * Returns:
+ *   Returns 0 (skipped), 1, 2, 4, 8 or 16.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_config.hpp
+ */
+constexpr int OsrsSamples(Osrs osrs)
+{
+    return ((uint8_t)osrs & 0x07) == 0 ? 0
+         : ((uint8_t)osrs & 0x07) >= 5 ? 16
+         : 1 << (((uint8_t)osrs & 0x07) - 1);
+}
+
+/*
+ * constexpr unsigned int StandbyTime(Standby tsb)
+ *
+ * Description:
+ *   Normal-mode standby time, in microseconds.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_config.hpp
+ */
+constexpr unsigned int StandbyTime(Standby tsb)
+{
+    return ((uint8_t)tsb & 0x07) == 0 ? 500
+         : ((uint8_t)tsb & 0x07) == 1 ? 62500
+         : 125000u << (((uint8_t)tsb & 0x07) - 2);
+}
+
+
+/*
+ * struct BMP280Config
+ *
+ * Description:
+ *   One complete device configuration: the ctrl_meas fields (osrs_t,
+ *   osrs_p, mode) and the config fields (t_sb, filter).
+ *
+ *   Valid() rejects combinations that cannot produce a compensated
+ *   reading: temperature skipped while pressure is measured (pressure
+ *   compensation needs t_fine from the temperature reading), or both
+ *   measurements skipped outside sleep mode.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_config.hpp
+ */
+struct BMP280Config
+{
+    Osrs     ost;
+    Osrs     osp;
+    Mode     mode;
+    Standby  tsb;
+    Filter   filter;
+
+    constexpr BMP280Config ( Osrs t, Osrs p, Mode m,
+                             Standby sb=Standby::Ms0_5, Filter f=Filter::Off )
+        : ost(t), osp(p), mode(m), tsb(sb), filter(f)
+    { }
+
+    // Decodes a pair of register values.
+    static constexpr BMP280Config FromRegs ( uint8_t ctrl, uint8_t conf )
+    {
+        return BMP280Config( (Osrs)((ctrl & BMP280_OS_T_MSK) >> 5),
+                             (Osrs)((ctrl & BMP280_OS_P_MSK) >> 2),
+                             (ctrl & BMP280_MODE_MSK) == 0 ? Mode::Sleep
+                           : (ctrl & BMP280_MODE_MSK) == 3 ? Mode::Normal : Mode::Forced,
+                             (Standby)((conf & BMP280_T_SB_MASK) >> 5),
+                             (Filter)((conf & BMP280_FILTER_MASK) >> 2) );
+    }
+
+    // ctrl_meas register value.
+    constexpr uint8_t Ctrl () const
+    {
+        return (uint8_t)( ((uint8_t)ost << 5) | ((uint8_t)osp << 2) | (uint8_t)mode );
+    }
+
+    // config register value. spi3w_en is left clear.
+    constexpr uint8_t Conf () const
+    {
+        return (uint8_t)( ((uint8_t)tsb << 5) | ((uint8_t)filter << 2) );
+    }
+
+    constexpr bool Valid () const
+    {
+        return !(ost == Osrs::Skip && osp != Osrs::Skip)
+            && !(mode != Mode::Sleep && ost == Osrs::Skip);
+    }
+
+    // Returns *this if Valid(). Otherwise throws, which fails the
+    // build in a constant expression.
+    constexpr BMP280Config Checked () const
+    {
+        return Valid() ? *this
+             : throw std::runtime_error("BMP280Config::Checked(): Invalid configuration.");
+    }
+
+    // Maximum conversion time, in microseconds (datasheet 3.8.1).
+    constexpr unsigned int MeasureTime () const
+    {
+        return BMP280_T_MEAS_BASE + BMP280_T_MEAS_OS*OsrsSamples(ost)
+             + (OsrsSamples(osp) > 0 ? BMP280_T_MEAS_OS*OsrsSamples(osp) + BMP280_T_MEAS_PRESS : 0);
+    }
+
+    // Time between readings, in microseconds: conversion plus standby
+    // in normal mode, conversion alone for a forced reading.
+    constexpr unsigned int Period () const
+    {
+        return MeasureTime() + (mode == Mode::Normal ? StandbyTime(tsb) : 0);
+    }
+
+    // Output data rate, in readings per second. Based on the maximum
+    // conversion time, so the device may run slightly faster.
+    constexpr double Odr () const
+    {
+        return 1000000.0 / Period();
+    }
+
+}; // struct BMP280Config
+
+
+// Datasheet presets 1..6 (BST-BMP280-DS001-19, section 3.4).
+constexpr BMP280Config BMP280Presets[6] =
+{
+    { Osrs::X2, Osrs::X16, Mode::Normal, Standby::Ms62_5, Filter::X4  },  // hand held, low power
+    { Osrs::X1, Osrs::X4,  Mode::Normal, Standby::Ms0_5,  Filter::X16 },  // hand held, dynamic
+    { Osrs::X1, Osrs::X1,  Mode::Forced, Standby::Ms4000, Filter::Off },  // weather monitoring
+    { Osrs::X1, Osrs::X4,  Mode::Normal, Standby::Ms125,  Filter::X4  },  // elevator floor change
+    { Osrs::X1, Osrs::X2,  Mode::Normal, Standby::Ms0_5,  Filter::Off },  // drop detection
+    { Osrs::X2, Osrs::X16, Mode::Normal, Standby::Ms0_5,  Filter::X16 }   // indoor navigation
+};
+
+static_assert(BMP280Presets[0].Ctrl() == BMP280_CTRL_PRE1 && BMP280Presets[0].Conf() == BMP280_CONF_PRE1, "preset 1");
+static_assert(BMP280Presets[1].Ctrl() == BMP280_CTRL_PRE2 && BMP280Presets[1].Conf() == BMP280_CONF_PRE2, "preset 2");
+static_assert(BMP280Presets[2].Ctrl() == BMP280_CTRL_PRE3 && BMP280Presets[2].Conf() == BMP280_CONF_PRE3, "preset 3");
+static_assert(BMP280Presets[3].Ctrl() == BMP280_CTRL_PRE4 && BMP280Presets[3].Conf() == BMP280_CONF_PRE4, "preset 4");
+static_assert(BMP280Presets[4].Ctrl() == BMP280_CTRL_PRE5 && BMP280Presets[4].Conf() == BMP280_CONF_PRE5, "preset 5");
+static_assert(BMP280Presets[5].Ctrl() == BMP280_CTRL_PRE6 && BMP280Presets[5].Conf() == BMP280_CONF_PRE6, "preset 6");
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_CONFIG_HPP_ */
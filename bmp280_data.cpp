@@ -1,4 +1,3 @@
-```
 /*
  * bmp280_data.cpp
  *
@@ -10,11 +9,13 @@
  */
 
 
-#include <ctime>             // time_t, time()
+#include <cmath>             // sqrt()
+#include <ctime>             // time_t, time(), clock_gettime()
 #include <stdexcept>         // runtime_error
-#include <stdint.h>          // int32_t, uint32_t
+#include <stdint.h>          // int32_t, uint32_t, int64_t
 
 #include "bmp280.hpp"
+#include "bmp280_simd.hpp"   // SummarizeI32(), SummarizeU32()
 
 using namespace std;
 
@@ -61,11 +62,33 @@ CalParams::CalParams()
 // -----------------------------------------------------------------
 
 /*
- * TP32Data::TP32Data( int32_t temp, int32_t press )
+ * int64_t MonotonicNs()
  *
  * Description:
- *   Constructor. Sets the timestamp, along with temperature and
- *   pressure values.
+ *   Reads BMP280_CLOCK.
+ *
+ * Returns:
+ *   The clock, in nanoseconds.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+int64_t MonotonicNs()
+{
+    struct timespec ts;
+    clock_gettime(BMP280_CLOCK, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*
+ * TP32Data::TP32Data( int32_t temp, uint32_t press )
+ *
+ * Description:
+ *   Constructor. Sets temperature and pressure values. Time stamps
+ *   are set to zero; no clock is read.
  *
  * Parameters:
  *   temp  - optional. Temperature value. The default value is zero.
@@ -75,47 +98,668 @@ CalParams::CalParams()
  *   bosch_bmp280
  *
  * Header File(s);
- *   bmp280.hpp
+ *   bmp280.hpp
+ */
+TP32Data::TP32Data( int32_t temp, uint32_t press )
+{
+    timestamp   = 0;
+    monotime    = 0;
+    temperature = temp;
+    pressure    = press;
+}
+
+/*
+ * void TP32Data::Stamp()
+ *
+ * Description:
+ *   Sets monotime from MonotonicNs() and timestamp from the wall
+ *   clock. Call it once, right after the bus read the values came
+ *   from.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+void TP32Data::Stamp()
+{
+    monotime  = MonotonicNs();
+    timestamp = time(nullptr);
+}
+
+
+// TPDoubleData
+// -----------------------------------------------------------------
+
+/*
+ * TPDoubleData::TPDoubleData( double temp, double press )
+ *
+ * Description:
+ *   Constructor. Sets temperature and pressure values. Time stamps
+ *   are set to zero; no clock is read.
+ *
+ * Parameters:
+ *   temp  - optional. Temperature value. The default value is zero.
+ *   press - optional. Pressure value.    The default value is zero.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+TPDoubleData::TPDoubleData( double temp, double press )
+{
+    timestamp   = 0;
+    monotime    = 0;
+    temperature = temp;
+    pressure    = press;
+}
+
+
+// TP32Aggregate
+// -----------------------------------------------------------------
+
+/*
+ * Converts sums of deviations from ref into the average and the
+ * (population) variance of n readings. n must not be zero.
+ */
+static void Moments(int64_t ref, int64_t sum, int64_t sumsq, size_t n,
+                    double& avg, double& var)
+{
+    double m = (double)sum/(double)n;
+
+    avg = (double)ref + m;
+    var = (double)sumsq/(double)n - m*m;
+    if (var < 0.0)
+        var = 0.0;
+}
+
+/*
+ * TP32Aggregate::TP32Aggregate()
+ *
+ * Description:
+ *   Constructor. An empty aggregate.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_data.hpp
+ */
+TP32Aggregate::TP32Aggregate()
+{
+    count = 0;
+    thigh = INT32_MIN;
+    tlow  = INT32_MAX;
+    phigh = 0;
+    plow  = UINT32_MAX;
+    tsum  = tsq = 0;
+    psum  = psq = 0;
+}
+
+/*
+ * void TP32Aggregate::add(int32_t temp, uint32_t press,
+ *                         int32_t tref, uint32_t pref)
+ *
+ * Description:
+ *   Adds one reading.
+ *
+ * Parameters:
+ *   temp  - the reading's temperature
+ *   press - the reading's pressure
+ *   tref  - the owner's temperature reference
+ *   pref  - the owner's pressure reference
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_data.hpp
+ */
+void TP32Aggregate::add(int32_t temp, uint32_t press, int32_t tref, uint32_t pref)
+{
+    int64_t td = (int64_t)temp  - tref;
+    int64_t pd = (int64_t)press - pref;
+
+    count++;
+    if (temp  > thigh) thigh = temp;
+    if (temp  < tlow)  tlow  = temp;
+    if (press > phigh) phigh = press;
+    if (press < plow)  plow  = press;
+    tsum += td;  tsq += td*td;
+    psum += pd;  psq += pd*pd;
+}
+
+/*
+ * void TP32Aggregate::merge(const TP32Aggregate& a)
+ *
+ * Description:
+ *   Adds the readings of another aggregate, which must have been
+ *   taken with the same references. Merging an empty aggregate
+ *   changes nothing.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_data.hpp
+ */
+void TP32Aggregate::merge(const TP32Aggregate& a)
+{
+    count += a.count;
+    if (a.thigh > thigh) thigh = a.thigh;
+    if (a.tlow  < tlow)  tlow  = a.tlow;
+    if (a.phigh > phigh) phigh = a.phigh;
+    if (a.plow  < plow)  plow  = a.plow;
+    tsum += a.tsum;  tsq += a.tsq;
+    psum += a.psum;  psq += a.psq;
+}
+
+/*
+ * void TP32Aggregate::summary(int32_t tref, uint32_t pref,
+ *                             time_t tstart, time_t tstop,
+ *                             TP32Summary& temp, TP32Summary& press) const
+ *
+ * Description:
+ *   Fills in temperature and pressure summaries. If the aggregate is
+ *   empty, both hold zeroes, time stamps included.
+ *
+ * Parameters:
+ *   tref   - the temperature reference the sums were taken with
+ *   pref   - the pressure reference
+ *   tstart - time stamp of the first reading
+ *   tstop  - time stamp of the last reading
+ *   temp   - receives the temperature summary
+ *   press  - receives the pressure summary
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_data.hpp
+ */
+void TP32Aggregate::summary(int32_t tref, uint32_t pref, time_t tstart, time_t tstop,
+                            TP32Summary& temp, TP32Summary& press) const
+{
+    temp.samplecount = press.samplecount = count;
+    temp.timestart   = press.timestart   = 0;
+    temp.timestop    = press.timestop    = 0;
+    temp.high        = temp.low  = 0;
+    press.high       = press.low = 0;
+    temp.average     = press.average = 0.0;
+    temp.stddev      = press.stddev  = 0.0;
+
+    if (count == 0)
+        return;
+
+    double avg, var;
+
+    temp.timestart = press.timestart = tstart;
+    temp.timestop  = press.timestop  = tstop;
+
+    Moments(tref, tsum, tsq, (size_t)count, avg, var);
+    temp.high    = thigh;
+    temp.low     = tlow;
+    temp.average = avg;
+    temp.stddev  = sqrt(var);
+
+    Moments(pref, psum, psq, (size_t)count, avg, var);
+    press.high    = (int32_t)phigh;
+    press.low     = (int32_t)plow;
+    press.average = avg;
+    press.stddev  = sqrt(var);
+}
+
+
+// TP32DataQueue
+// -----------------------------------------------------------------
+
+/*
+ * Capacity of the high/low queues: only incremental mode uses them.
+ */
+static size_t TrackSize(int capacity, int options)
+{
+    return (options & TP32Q_OPT_INCREMENTAL) ? (size_t)capacity : 0;
+}
+
+/*
+ * TP32DataQueue::TP32DataQueue(int capacity, int options)
+ *
+ * Description:
+ *   Constructor. Sets the queue maximum capacity and options, and
+ *   allocates storage for that many readings (and, in incremental
+ *   mode, for the high/low queues). Initializes summary data.
+ *
+ * Parameters:
+ *   capacity - optional. Maximum number of readings. Default is 60.
+ *   options  - optional. Zero or more TP32Q_OPT_ flags, or'ed
+ *              together. Default is TP32Q_OPT_NONE.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+TP32DataQueue::TP32DataQueue(int capacity, int options)
+    : dqtime(capacity), dqmono(capacity), dqtemp(capacity), dqpress(capacity),
+      tmaxq(TrackSize(capacity, options)), tminq(TrackSize(capacity, options)),
+      pmaxq(TrackSize(capacity, options)), pminq(TrackSize(capacity, options))
+{
+    qcap  = capacity;
+    qopts = options;
+    inversions = 0;
+
+    t_high = INT32_MIN;
+    t_low  = INT32_MAX;
+    t_avg  = 0.0;
+    t_var  = 0.0;
+    p_high = 0;
+    p_low  = INT32_MAX;
+    p_avg  = 0.0;
+    p_var  = 0.0;
+
+    stale = true;
+
+    this->resettrack();
+
+    rleaves = 0;
+    if (qopts & TP32Q_OPT_RANGE)
+    {
+        rleaves = 1;
+        while (rleaves < qcap)
+            rleaves <<= 1;
+        rtree.assign(2*rleaves, TP32Aggregate());
+    }
+}
+
+
+// TP32DataQueue Protected
+// -----------------------------------------------------------------
+
+/*
+ * void TP32DataQueue::track(const TP32Data& tpd)
+ *
+ * Description:
+ *   Incremental mode. Adds a reading that has just been pushed to
+ *   the running sums and to the monotonic high/low queues.
+ *
+ *   Running sums are of deviations from the first reading pushed
+ *   to an empty queue (tref, pref), and of their squares. They are
+ *   exact 64-bit integers, so readings can be added and removed
+ *   indefinitely without drift.
+ *
+ *   Each high queue holds values in decreasing order, each low
+ *   queue in increasing order, so the current high or low is
+ *   always at the front. Values that can never become the high
+ *   (or low) again are dropped from the back.
+ *
+ * Parameters:
+ *   tpd - the reading that was pushed to the back of the queue
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void TP32DataQueue::track(const TP32Data& tpd)
+{
+    TP32Extreme tx { seqnext, (int64_t)tpd.temperature };
+    TP32Extreme px { seqnext, (int64_t)tpd.pressure    };
+
+    if (seqfront == seqnext)
+    {
+        tref = tpd.temperature;
+        pref = tpd.pressure;
+    }
+    seqnext++;
+
+    int64_t td = tx.value - tref;
+    int64_t pd = px.value - pref;
+    tsum += td;
+    psum += pd;
+    tsq  += td*td;
+    psq  += pd*pd;
+
+    while (!tmaxq.empty() && tmaxq.back().value <= tx.value) tmaxq.pop_back();
+    while (!tminq.empty() && tminq.back().value >= tx.value) tminq.pop_back();
+    while (!pmaxq.empty() && pmaxq.back().value <= px.value) pmaxq.pop_back();
+    while (!pminq.empty() && pminq.back().value >= px.value) pminq.pop_back();
+
+    tmaxq.push_back(tx);
+    tminq.push_back(tx);
+    pmaxq.push_back(px);
+    pminq.push_back(px);
+}
+
+/*
+ * void TP32DataQueue::untrack()
+ *
+ * Description:
+ *   Incremental mode. Removes the reading at the front of the queue
+ *   from the running sums and the high/low queues. Must be called
+ *   just before that reading is removed from the queue.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void TP32DataQueue::untrack()
+{
+    int64_t td = (int64_t)dqtemp.front()  - tref;
+    int64_t pd = (int64_t)dqpress.front() - pref;
+    tsum -= td;
+    psum -= pd;
+    tsq  -= td*td;
+    psq  -= pd*pd;
+
+    if (!tmaxq.empty() && tmaxq.front().seq == seqfront) tmaxq.pop_front();
+    if (!tminq.empty() && tminq.front().seq == seqfront) tminq.pop_front();
+    if (!pmaxq.empty() && pmaxq.front().seq == seqfront) pmaxq.pop_front();
+    if (!pminq.empty() && pminq.front().seq == seqfront) pminq.pop_front();
+
+    seqfront++;
+}
+
+/*
+ * void TP32DataQueue::resettrack()
+ *
+ * Description:
+ *   Incremental mode. Clears running sums and high/low queues.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+void TP32DataQueue::resettrack()
+{
+    seqfront = 0;
+    seqnext  = 0;
+    tref     = 0;
+    pref     = 0;
+    tsum     = 0;
+    psum     = 0;
+    tsq      = 0;
+    psq      = 0;
+
+    tmaxq.clear();
+    tminq.clear();
+    pmaxq.clear();
+    pminq.clear();
+}
+
+/*
+ * void TP32DataQueue::rangeset(size_t pos, const TP32Aggregate& leaf)
+ *
+ * Description:
+ *   Range mode. Sets the segment tree leaf for a storage position
+ *   and updates the nodes above it.
+ *
+ * Parameters:
+ *   pos  - storage position (see RingBuffer::position())
+ *   leaf - the reading's leaf, or an empty aggregate when it leaves
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+void TP32DataQueue::rangeset(size_t pos, const TP32Aggregate& leaf)
+{
+    size_t i = rleaves + pos;
+
+    rtree[i] = leaf;
+    for (i >>= 1; i > 0; i >>= 1)
+    {
+        rtree[i] = rtree[2*i];
+        rtree[i].merge(rtree[2*i + 1]);
+    }
+}
+
+/*
+ * void TP32DataQueue::rangequery(size_t lo, size_t hi, TP32Aggregate& acc)
+ *
+ * Description:
+ *   Range mode. Adds readings lo (inclusive) to hi (exclusive),
+ *   counted from the front, into acc. The readings occupy one or two
+ *   runs of storage, each covered by O(log n) tree nodes.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+void TP32DataQueue::rangequery(size_t lo, size_t hi, TP32Aggregate& acc)
+{
+    size_t a   = dqtime.position(lo);
+    size_t len = hi - lo;
+    size_t runs[2][2] = { {a, a + len}, {0, 0} };
+
+    if (a + len > qcap)
+    {
+        runs[0][1] = qcap;
+        runs[1][1] = a + len - qcap;
+    }
+
+    for (int k = 0; k < 2; k++)
+    {
+        size_t l = runs[k][0] + rleaves;
+        size_t r = runs[k][1] + rleaves;
+
+        for ( ; l < r; l >>= 1, r >>= 1)
+        {
+            if (l & 1) acc.merge(rtree[l++]);
+            if (r & 1) acc.merge(rtree[--r]);
+        }
+    }
+}
+
+/*
+ * void TP32DataQueue::rangescan(size_t lo, size_t hi, int32_t tr, uint32_t pr,
+ *                               TP32Aggregate& acc)
+ *
+ * Description:
+ *   Adds readings lo (inclusive) to hi (exclusive), counted from the
+ *   front, into acc, by scanning them in place. Deviations are taken
+ *   from tr and pr.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+void TP32DataQueue::rangescan(size_t lo, size_t hi, int32_t tr, uint32_t pr, TP32Aggregate& acc)
+{
+    size_t len  = hi - lo;
+    size_t run1 = qcap - dqtime.position(lo);
+
+    if (run1 > len)
+        run1 = len;
+
+    SummarizeI32(&dqtemp[lo],  run1, tr, acc.thigh, acc.tlow, acc.tsum, acc.tsq);
+    SummarizeU32(&dqpress[lo], run1, pr, acc.phigh, acc.plow, acc.psum, acc.psq);
+    if (len > run1)
+    {
+        SummarizeI32(&dqtemp[lo + run1],  len - run1, tr, acc.thigh, acc.tlow, acc.tsum, acc.tsq);
+        SummarizeU32(&dqpress[lo + run1], len - run1, pr, acc.phigh, acc.plow, acc.psum, acc.psq);
+    }
+    acc.count += (int32_t)len;
+}
+
+/*
+ * size_t TP32DataQueue::search(time_t t, bool after)
+ *
+ * Description:
+ *   Binary search on the time stamp column.
+ *
+ * Parameters:
+ *   t     - the time stamp to look for
+ *   after - false to find the first reading at or after t, true to
+ *           find the first reading after t
+ *
+ * Returns:
+ *   Returns the index of the reading found, counted from the front,
+ *   or size() if there is none.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+size_t TP32DataQueue::search(time_t t, bool after)
+{
+    size_t lo = 0;
+    size_t hi = dqtime.size();
+
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo)/2;
+        time_t tm  = dqtime[mid];
+
+        if (tm < t || (after && tm == t))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/*
+ * size_t TP32DataQueue::searchmono(int64_t t, bool after)
+ *
+ * Description:
+ *   Binary search on the monotonic time stamp column, as search().
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
  */
-TP32Data::TP32Data( int32_t temp, int32_t press )
+size_t TP32DataQueue::searchmono(int64_t t, bool after)
 {
-    timestamp   = time(nullptr);
-    temperature = temp;
-    pressure    = press;
+    size_t lo = 0;
+    size_t hi = dqmono.size();
+
+    while (lo < hi)
+    {
+        size_t  mid = lo + (hi - lo)/2;
+        int64_t tm  = dqmono[mid];
+
+        if (tm < t || (after && tm == t))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
 }
 
+/*
+ * void TP32DataQueue::popfront()
+ *
+ * Description:
+ *   Removes the front reading from every column, and from whichever
+ *   of the running sums, segment tree and order count it is in.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+void TP32DataQueue::popfront()
+{
+    if (qopts & TP32Q_OPT_INCREMENTAL)
+        this->untrack();
+    if (qopts & TP32Q_OPT_RANGE)
+        this->rangeset(dqtime.position(0), TP32Aggregate());
+    if (dqtime.size() >= 2 && dqtime[0] > dqtime[1])
+        inversions--;
 
-// TP32DataQueue
-// -----------------------------------------------------------------
+    dqtime.pop_front();
+    dqmono.pop_front();
+    dqtemp.pop_front();
+    dqpress.pop_front();
+}
 
 /*
- * TP32DataQueue::TP32DataQueue(int capacity)
+ * void TP32DataQueue::publish()
  *
  * Description:
- *   Constructor. Sets the queue maximum capacity.
- *   Initializes summary data.
+ *   Snapshot mode. Summarizes the queue, if need be, and publishes
+ *   both summaries for Snapshot().
  *
  * Namespace:
  *   bosch_bmp280
  *
  * Header File(s);
- *   bmp280.hpp
+ *   bmp280_data.hpp
  */
-TP32DataQueue::TP32DataQueue(int capacity)
+void TP32DataQueue::publish()
 {
-    qcap = capacity;
+    TP32Snapshot s;
 
-    t_high = INT32_MIN;
-    t_low  = INT32_MAX;
-    t_avg  = 0.0;
-    p_high = 0;
-    p_low  = INT32_MAX;
-    p_avg  = 0.0;
+    if (dqtime.size() > 0)
+    {
+        s.temperature = this->TemperatureSummary();
+        s.pressure    = this->PressureSummary();
+    }
+    else
+    {
+        TP32Summary none { 0, 0, 0, 0, 0, 0.0, 0.0 };
+        s.temperature = none;
+        s.pressure    = none;
+    }
 
-    stale = true;
+    snap.store(s);
+}
+
+/*
+ * TP32Data TP32DataQueue::reading(size_t i)
+ *
+ * Description:
+ *   Gathers the i-th reading from the front of the queue out of the
+ *   time, temperature and pressure columns.
+ *
+ * Parameters:
+ *   i - index from the front of the queue. Must be less than size().
+ *
+ * Returns:
+ *   Returns a TP32Data object.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+TP32Data TP32DataQueue::reading(size_t i)
+{
+    TP32Data tpd { dqtemp[i], dqpress[i] };
+    tpd.timestamp = dqtime[i];
+    tpd.monotime  = dqmono[i];
+
+    return tpd;
 }
 
 
+// TP32DataQueue Public
+// -----------------------------------------------------------------
+
+
 /*
  * TP32Data TP32DataQueue::back()
  *
@@ -140,13 +784,13 @@ TP32DataQueue::TP32DataQueue(int capacity)
  */
 TP32Data TP32DataQueue::back()
 {
-    if (dq.size() < 1)
+    if (dqtime.size() < 1)
     {
         runtime_error re {"TP32DataQueue::back(): The queue is empty."};
         throw re;
     }
 
-    return dq.back();
+    return this->reading(dqtime.size() - 1);
 }
 
 /*
@@ -174,13 +818,13 @@ TP32Data TP32DataQueue::back()
  */
 TP32Data TP32DataQueue::front()
 {
-    if (dq.size() < 1)
+    if (dqtime.size() < 1)
     {
         runtime_error re {"TP32DataQueue::front(): The queue is empty."};
         throw re;
     }
 
-    return dq.front();
+    return this->reading(0);
 }
 
 /*
@@ -206,15 +850,17 @@ TP32Data TP32DataQueue::front()
  */
 TP32Data TP32DataQueue::pop()
 {
-    if (dq.size() < 1)
+    if (dqtime.size() < 1)
     {
         runtime_error re {"TP32DataQueue::pop(): The queue is empty."};
         throw re;
     }
 
-    TP32Data tpd{ dq.front() };
-    dq.pop_front();
+    TP32Data tpd{ this->reading(0) };
+    this->popfront();
     stale = true;
+    if (qopts & TP32Q_OPT_SNAPSHOT)
+        this->publish();
 
     return tpd;
 }
@@ -225,8 +871,8 @@ TP32Data TP32DataQueue::pop()
  * Description:
  *   Adds a TP32Data object to the back of the queue.
  *
- *   If this causes the queue's size to exceed its configured capacity,
- *   data is removed from the front until size equals capacity.
+ *   If the queue is already at its configured capacity, the oldest
+ *   reading is removed from the front to make room.
  *
  * Parameters:
  *   tpd - A TP32Data object to be added to the back of the queue.
@@ -242,15 +888,41 @@ TP32Data TP32DataQueue::pop()
  */
 int TP32DataQueue::push(TP32Data tpd)
 {
-    dq.push_back(tpd);
-    while (dq.size() > qcap)
+    bool incremental = (qopts & TP32Q_OPT_INCREMENTAL);
+    bool ranged      = (qopts & TP32Q_OPT_RANGE);
+
+    if (qcap == 0)
+        return 0;
+
+    while (dqtime.size() >= qcap)
+        this->popfront();
+
+    if (!dqtime.empty() && tpd.timestamp < dqtime.back())
+        inversions++;
+
+    dqtime.push_back(tpd.timestamp);
+    dqmono.push_back(tpd.monotime);
+    dqtemp.push_back(tpd.temperature);
+    dqpress.push_back(tpd.pressure);
+    if (incremental)
+        this->track(tpd);
+    if (ranged)
     {
-        dq.pop_front();
+        if (dqtime.size() == 1)
+        {
+            tref = tpd.temperature;
+            pref = tpd.pressure;
+        }
+        TP32Aggregate leaf;
+        leaf.add(tpd.temperature, tpd.pressure, tref, pref);
+        this->rangeset(dqtime.position(dqtime.size() - 1), leaf);
     }
 
     stale = true;
+    if (qopts & TP32Q_OPT_SNAPSHOT)
+        this->publish();
 
-    return dq.size();
+    return dqtime.size();
 }
 
 /*
@@ -273,6 +945,26 @@ int TP32DataQueue::capacity()
     return qcap;
 }
 
+/*
+ * int TP32DataQueue::options()
+ *
+ * Description:
+ *   Returns the TP32Q_OPT_ flags the queue was constructed with.
+ *
+ * Returns:
+ *   Returns the configured queue options.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+int TP32DataQueue::options()
+{
+    return qopts;
+}
+
 /*
  * void TP32DataQueue::clear()
  *
@@ -287,8 +979,17 @@ int TP32DataQueue::capacity()
  */
 void TP32DataQueue::clear()
 {
-    dq.clear();
+    dqtime.clear();
+    dqmono.clear();
+    dqtemp.clear();
+    dqpress.clear();
+    inversions = 0;
+    this->resettrack();
+    if (qopts & TP32Q_OPT_RANGE)
+        rtree.assign(2*rleaves, TP32Aggregate());
     stale = true;
+    if (qopts & TP32Q_OPT_SNAPSHOT)
+        this->publish();
 }
 
 /*
@@ -309,7 +1010,7 @@ void TP32DataQueue::clear()
  */
 bool TP32DataQueue::full()
 {
-    return (dq.size() >= qcap);
+    return (dqtime.size() >= qcap);
 }
 
 /*
@@ -329,7 +1030,31 @@ bool TP32DataQueue::full()
  */
 int TP32DataQueue::size()
 {
-    return dq.size();
+    return dqtime.size();
+}
+
+/*
+ * bool TP32DataQueue::ordered()
+ *
+ * Description:
+ *   Indicates whether the time stamps held never decrease from front
+ *   to back, as find() and RangeSummary() need. A reading pushed with
+ *   an earlier time stamp than the one before it (after the system
+ *   clock is stepped back) makes this false until it has been popped
+ *   or evicted.
+ *
+ * Returns:
+ *   Returns true if the time stamps are in order.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+bool TP32DataQueue::ordered()
+{
+    return (inversions == 0);
 }
 
 /*
@@ -338,6 +1063,16 @@ int TP32DataQueue::size()
  * Description:
  *   Re-calculates temperature and pressure summaries.
  *
+ *   In incremental mode, summaries are taken directly from the
+ *   running sums and high/low queues. Otherwise, the temperature
+ *   and pressure columns are scanned into a TP32Aggregate by
+ *   rangescan(), with the SummarizeI32() and SummarizeU32() kernels.
+ *
+ *   Either way, high, low, average and variance all come from the
+ *   same single pass, using 64-bit sums of deviations from a
+ *   reference reading, so the window size is not limited by
+ *   accumulator overflow.
+ *
  * Namespace:
  *   bosch_bmp280
  *
@@ -353,27 +1088,38 @@ void TP32DataQueue::summarize()
 
     t_avg = 0.0;
     p_avg = 0.0;
+    t_var = 0.0;
+    p_var = 0.0;
+
+    size_t count = dqtime.size();
 
-    if (dq.size() > 0)
+    if (count > 0 && (qopts & TP32Q_OPT_INCREMENTAL))
     {
-        int32_t temp, press;
-        int32_t tsum = 0;
-        int32_t psum = 0;
-        for (auto it = dq.cbegin(); it != dq.cend(); ++it)
-        {
-            temp  = ((TP32Data)*it).temperature;
-            if (temp > t_high)  t_high = temp;
-            if (temp < t_low)   t_low  = temp;
-            tsum += temp;
-
-            press = ((TP32Data)*it).pressure;
-            if (press > p_high) p_high = press;
-            if (press < p_low)  p_low  = press;
-            psum += press;
-        }
+        t_high = (int32_t)tmaxq.front().value;
+        t_low  = (int32_t)tminq.front().value;
+        p_high = (int32_t)pmaxq.front().value;
+        p_low  = (int32_t)pminq.front().value;
+
+        Moments(tref, tsum, tsq, count, t_avg, t_var);
+        Moments(pref, psum, psq, count, p_avg, p_var);
+
+        stale = false;
+    }
+    else if (count > 0)
+    {
+        TP32Aggregate acc;
+         int32_t tr = dqtemp.front();
+        uint32_t pr = dqpress.front();
+
+        this->rangescan(0, count, tr, pr, acc);
 
-        t_avg = (double)tsum/dq.size();
-        p_avg = (double)psum/dq.size();
+        t_high = acc.thigh;
+        t_low  = acc.tlow;
+        p_high = (int32_t)acc.phigh;
+        p_low  = (int32_t)acc.plow;
+
+        Moments(tr, acc.tsum, acc.tsq, count, t_avg, t_var);
+        Moments(pr, acc.psum, acc.psq, count, p_avg, p_var);
 
         stale = false;
     }
@@ -482,6 +1228,46 @@ double TP32DataQueue::temperature_average()
     return t_avg;
 }
 
+/*
+ * double TP32DataQueue::temperature_variance()
+ *
+ * Description:
+ *   Re-calculates summary data, if necessary, and returns the
+ *   population variance of all temperature readings in the queue.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+double TP32DataQueue::temperature_variance()
+{
+    if (stale)
+        this->summarize();
+
+    return t_var;
+}
+
+/*
+ * double TP32DataQueue::temperature_stddev()
+ *
+ * Description:
+ *   Re-calculates summary data, if necessary, and returns the
+ *   population standard deviation of all temperature readings
+ *   in the queue.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+double TP32DataQueue::temperature_stddev()
+{
+    return sqrt(this->temperature_variance());
+}
+
 /*
  * uint32_t TP32DataQueue::pressure_high()
  *
@@ -546,7 +1332,47 @@ double TP32DataQueue::pressure_average()
 }
 
 /*
- * TP32Summary TP32DataQueue::temperature_summary()
+ * double TP32DataQueue::pressure_variance()
+ *
+ * Description:
+ *   Re-calculates summary data, if necessary, and returns the
+ *   population variance of all pressure readings in the queue.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+double TP32DataQueue::pressure_variance()
+{
+    if (stale)
+        this->summarize();
+
+    return p_var;
+}
+
+/*
+ * double TP32DataQueue::pressure_stddev()
+ *
+ * Description:
+ *   Re-calculates summary data, if necessary, and returns the
+ *   population standard deviation of all pressure readings
+ *   in the queue.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280.hpp
+ */
+double TP32DataQueue::pressure_stddev()
+{
+    return sqrt(this->pressure_variance());
+}
+
+/*
+ * TP32Summary TP32DataQueue::TemperatureSummary()
  *
  * Description:
  *   Retrieves summary data for all temperature readings that
@@ -566,7 +1392,7 @@ double TP32DataQueue::pressure_average()
  * Header File(s);
  *   bmp280.hpp
  */
-TP32Summary TP32DataQueue::temperature_summary()
+TP32Summary TP32DataQueue::TemperatureSummary()
 {
     if (stale)
         this->summarize();
@@ -574,17 +1400,18 @@ TP32Summary TP32DataQueue::temperature_summary()
     TP32Summary tsummary;
     tsummary.timestart   = this->front().timestamp;
     tsummary.timestop    = this->back().timestamp;
-    tsummary.samplecount = dq.size();
+    tsummary.samplecount = dqtime.size();
 
     tsummary.high    = t_high;
     tsummary.low     = t_low;
     tsummary.average = t_avg;
+    tsummary.stddev  = sqrt(t_var);
 
     return tsummary;
 }
 
 /*
- * TP32Summary TP32DataQueue::pressure_summary()
+ * TP32Summary TP32DataQueue::PressureSummary()
  *
  * Description:
  *   Retrieves summary data for all pressure readings that
@@ -604,7 +1431,7 @@ TP32Summary TP32DataQueue::temperature_summary()
  * Header File(s);
  *   bmp280.hpp
  */
-TP32Summary TP32DataQueue::pressure_summary()
+TP32Summary TP32DataQueue::PressureSummary()
 {
     if (stale)
         this->summarize();
@@ -612,14 +1439,183 @@ TP32Summary TP32DataQueue::pressure_summary()
     TP32Summary psummary;
     psummary.timestart   = this->front().timestamp;
     psummary.timestop    = this->back().timestamp;
-    psummary.samplecount = dq.size();
+    psummary.samplecount = dqtime.size();
 
     psummary.high    = p_high;
     psummary.low     = p_low;
     psummary.average = p_avg;
+    psummary.stddev  = sqrt(p_var);
 
     return psummary;
 }
 
+
+/*
+ * int TP32DataQueue::find(time_t t)
+ *
+ * Description:
+ *   Finds the first reading with a time stamp at or after t, by
+ *   binary search. Needs ordered() time stamps.
+ *
+ * Parameters:
+ *   t - the time stamp to look for
+ *
+ * Returns:
+ *   Returns the index of the reading, counted from the front, or
+ *   size() if every reading is older than t.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+int TP32DataQueue::find(time_t t)
+{
+    return (int)this->search(t, false);
+}
+
+/*
+ * int TP32DataQueue::RangeSummary(time_t from, time_t to,
+ *                                 TP32Summary& temp, TP32Summary& press)
+ *
+ * Description:
+ *   Summarizes the readings with time stamps in [from, to], without
+ *   copying them out: for the last 90 seconds, say,
+ *
+ *     q.RangeSummary(q.timestop() - 90, q.timestop(), ts, ps);
+ *
+ *   The range is found by binary search. Its readings are then
+ *   scanned in place or, with TP32Q_OPT_RANGE, taken from the
+ *   segment tree in O(log n).
+ *
+ *   The search is only right while the wall-clock time stamps are in
+ *   order (see ordered()). Where the clock may be stepped, use
+ *   MonoRangeSummary().
+ *
+ * Parameters:
+ *   from  - start of the range, inclusive
+ *   to    - end of the range, inclusive
+ *   temp  - receives the temperature summary
+ *   press - receives the pressure summary
+ *
+ * Returns:
+ *   Returns the number of readings in the range. If it is zero, the
+ *   summaries hold zeroes.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+int TP32DataQueue::RangeSummary(time_t from, time_t to, TP32Summary& temp, TP32Summary& press)
+{
+    return this->rangesummary(this->search(from, false), this->search(to, true), temp, press);
+}
+
+/*
+ * int TP32DataQueue::MonoRangeSummary(int64_t from, int64_t to,
+ *                                     TP32Summary& temp, TP32Summary& press)
+ *
+ * Description:
+ *   As RangeSummary(), but the range is of monotonic time stamps
+ *   (TP32Data::monotime, nanoseconds), which stay in order whatever
+ *   is done to the wall clock. The summaries' timestart and timestop
+ *   are still wall-clock time stamps.
+ *
+ * Parameters:
+ *   from  - start of the range, inclusive
+ *   to    - end of the range, inclusive
+ *   temp  - receives the temperature summary
+ *   press - receives the pressure summary
+ *
+ * Returns:
+ *   Returns the number of readings in the range.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+int TP32DataQueue::MonoRangeSummary(int64_t from, int64_t to, TP32Summary& temp, TP32Summary& press)
+{
+    return this->rangesummary(this->searchmono(from, false), this->searchmono(to, true), temp, press);
+}
+
+
+/*
+ * int TP32DataQueue::rangesummary(size_t lo, size_t hi,
+ *                                 TP32Summary& temp, TP32Summary& press)
+ *
+ * Description:
+ *   Summarizes the readings with indexes in [lo, hi), for
+ *   RangeSummary() and MonoRangeSummary().
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+int TP32DataQueue::rangesummary(size_t lo, size_t hi, TP32Summary& temp, TP32Summary& press)
+{
+    TP32Aggregate acc;
+     int32_t tr = tref;
+    uint32_t pr = pref;
+
+    if (hi <= lo)
+    {
+        acc.summary(tr, pr, 0, 0, temp, press);
+        return 0;
+    }
+
+    if (qopts & TP32Q_OPT_RANGE)
+    {
+        this->rangequery(lo, hi, acc);
+    }
+    else
+    {
+        tr = dqtemp[lo];
+        pr = dqpress[lo];
+        this->rangescan(lo, hi, tr, pr, acc);
+    }
+
+    acc.summary(tr, pr, dqtime[lo], dqtime[hi - 1], temp, press);
+
+    return acc.count;
+}
+
+
+/*
+ * uint32_t TP32DataQueue::Snapshot(TP32Snapshot& snapshot) const
+ *
+ * Description:
+ *   Copies the summaries published by the latest push(), pop() or
+ *   clear(). Safe to call from any thread, at any time, without
+ *   holding mtx: it takes no lock and never delays the writer.
+ *
+ *   Needs the TP32Q_OPT_SNAPSHOT option. Without it, nothing is ever
+ *   published and the snapshot holds zeroes.
+ *
+ * Parameters:
+ *   snapshot - receives the summaries
+ *
+ * Returns:
+ *   Returns the number of publications so far. Zero means nothing
+ *   has been published. A reader that sees the same number twice
+ *   has the same snapshot twice.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_data.hpp
+ */
+uint32_t TP32DataQueue::Snapshot(TP32Snapshot& snapshot) const
+{
+    return snap.load(snapshot);
+}
+
 } // namespace bosch_bmp280
-```
@@ -1,4 +1,3 @@
-```
 /*
  * bmp280_data.hpp
  *
@@ -21,14 +20,34 @@
 #ifndef BMP280_DATA_HPP_
 #define BMP280_DATA_HPP_
 
-#include <ctime>             // time_t
-#include <deque>             // deque
-#include <mutex>             // mutex, lock_guard
-#include <stdint.h>          // int32_t, uint32_t
+#include <ctime>               // time_t, clockid_t, CLOCK_MONOTONIC
+#include <mutex>               // mutex, lock_guard
+#include <stdint.h>            // int32_t, uint32_t, int64_t
+#include <vector>              // vector
+
+#include "bmp280_ring.hpp"     // RingBuffer
+#include "bmp280_seqlock.hpp"  // SeqLock
 
 namespace bosch_bmp280
 {
 
+// Clock behind TP32Data::monotime. CLOCK_MONOTONIC is read through
+// the vDSO on Linux, so it costs no syscall. CLOCK_MONOTONIC_COARSE
+// is cheaper still, but only ticks at the kernel HZ (4 ms or so),
+// which is too coarse to order readings taken at tens of Hz.
+#ifndef BMP280_CLOCK
+#define BMP280_CLOCK  CLOCK_MONOTONIC
+#endif
+
+int64_t  MonotonicNs ();
+
+// TP32DataQueue Options
+#define TP32Q_OPT_NONE         0x00
+#define TP32Q_OPT_INCREMENTAL  0x01  // running sums, monotonic high/low
+#define TP32Q_OPT_RANGE        0x02  // segment tree for time-range queries
+#define TP32Q_OPT_SNAPSHOT     0x04  // publish summaries for lock-free readers
+
+
 /*
  * struct CalParams
  *
@@ -73,6 +92,13 @@ struct CalParams
  *     1.  raw temperature and pressure data, or
  *     2.  results from 32-bit fixed-point compensation.
  *
+ *   Construction does not read any clock; both time stamps start at
+ *   zero. Stamp() sets them, and BMP280 calls it once for each bus
+ *   read, so a reading carries the time its registers were read.
+ *   monotime (nanoseconds, BMP280_CLOCK) is the one to order and
+ *   space readings by. timestamp is wall-clock seconds, for display
+ *   and for anything that keys on calendar time.
+ *
  * Namespace:
  *   bosch_bmp280
  *
@@ -82,10 +108,40 @@ struct CalParams
 struct TP32Data
 {
      time_t   timestamp;
+     int64_t  monotime;
      int32_t  temperature;
     uint32_t  pressure;
 
     TP32Data ( int32_t temp=0, uint32_t press=0 );
+
+    void  Stamp ();
+};
+
+/*
+ * struct TPDoubleData
+ *
+ * Description:
+ *   A structure for recording temperature and pressure data as
+ *   doubles. Holds results from double-precision compensation:
+ *   temperature in degrees centigrade, pressure in pascals.
+ *
+ *   Time stamps are as for TP32Data, and are copied from the raw
+ *   reading by compensation.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_data.hpp
+ */
+struct TPDoubleData
+{
+    time_t   timestamp;
+    int64_t  monotime;
+    double   temperature;
+    double   pressure;
+
+    TPDoubleData ( double temp=0.0, double press=0.0 );
 };
 
 /*
@@ -94,6 +150,9 @@ struct TP32Data
  * Description:
  *   Summarize a set of temperature or pressure readings.
  *
+ *   stddev is the population standard deviation, in the same
+ *   units as high, low and average.
+ *
  * Namespace:
  *   bosch_bmp280
  *
@@ -109,6 +168,84 @@ struct TP32Summary
     int32_t high;
     int32_t low;
     double  average;
+    double  stddev;
+};
+
+/*
+ * struct TP32Snapshot
+ *
+ * Description:
+ *   Temperature and pressure summaries of a whole TP32DataQueue, as
+ *   published for lock-free readers (see TP32Q_OPT_SNAPSHOT). Both
+ *   summaries have samplecount zero if the queue was empty.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_data.hpp
+ */
+struct TP32Snapshot
+{
+    TP32Summary  temperature;
+    TP32Summary  pressure;
+};
+
+/*
+ * struct TP32Extreme
+ *
+ * Description:
+ *   One entry in a monotonic high/low tracking queue. The sequence
+ *   number identifies the reading that produced the value, so that
+ *   the entry can be retired when that reading leaves the window.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_data.hpp
+ */
+struct TP32Extreme
+{
+    uint64_t  seq;
+     int64_t  value;
+};
+
+/*
+ * struct TP32Aggregate
+ *
+ * Description:
+ *   The high, low and moment sums of a set of readings: everything a
+ *   pair of TP32Summary needs except the time stamps. Moment sums are
+ *   of deviations from reference values (tref and pref) chosen by the
+ *   owner and used for every aggregate it keeps, so that aggregates
+ *   merge exactly and long windows lose nothing to cancellation.
+ *
+ *   This is the node of the TP32DataQueue range tree, the per-chunk
+ *   summary of a TP32Series and the bucket of a TP32Pyramid. A newly
+ *   constructed aggregate is empty: count zero, and high and low set
+ *   so that any reading replaces them.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_data.hpp
+ */
+struct TP32Aggregate
+{
+     int32_t  count;
+     int32_t  thigh, tlow;
+    uint32_t  phigh, plow;
+     int64_t  tsum, tsq;             // deviations from tref
+     int64_t  psum, psq;             // deviations from pref
+
+    TP32Aggregate ();
+
+    void  add     ( int32_t temp, uint32_t press, int32_t tref, uint32_t pref );
+    void  merge   ( const TP32Aggregate& a );
+    void  summary ( int32_t tref, uint32_t pref, time_t tstart, time_t tstop,
+                    TP32Summary& temp, TP32Summary& press ) const;
 };
 
 
@@ -129,6 +266,35 @@ struct TP32Summary
  *   number of readings and the frequency at which they are
  *   pushed.
  *
+ *   Readings are held column-wise, with time stamps, temperatures
+ *   and pressures in three separate RingBuffers. Each is allocated
+ *   once, at construction, so pushing to a full queue never touches
+ *   the heap, and summaries scan contiguous arrays of one field.
+ *
+ *   By default, summary data is re-calculated by scanning the
+ *   whole queue whenever it is requested after a push or a pop.
+ *   With the TP32Q_OPT_INCREMENTAL option, the queue keeps running
+ *   sums and monotonic high/low queues instead, so that push, pop
+ *   and every summary query cost O(1), amortized.
+ *
+ *   RangeSummary() summarizes the readings between two time stamps,
+ *   found by binary search, without copying anything out. By default
+ *   it scans the readings in the range. With the TP32Q_OPT_RANGE
+ *   option, the queue also keeps a segment tree over the ring storage
+ *   and answers in O(log n), at the cost of O(log n) per push and pop.
+ *   The search needs time stamps that do not decrease from front to
+ *   back, which wall-clock time stamps need not do (an NTP step back,
+ *   say): ordered() says whether they currently hold. Monotonic time
+ *   stamps always do, and MonoRangeSummary() searches those instead.
+ *
+ *   The queue is not itself thread-safe; callers share mtx. The one
+ *   exception is Snapshot(). With the TP32Q_OPT_SNAPSHOT option,
+ *   every push(), pop() and clear() publishes the whole-queue
+ *   summaries through a SeqLock, and any number of threads may call
+ *   Snapshot() at any time, without mtx, and without ever delaying
+ *   the writer. Publishing re-summarizes the queue, so pair the
+ *   option with TP32Q_OPT_INCREMENTAL to keep that O(1).
+ *
  * Namespace:
  *   bosch_bmp280
  *
@@ -139,18 +305,57 @@ class TP32DataQueue
 {
 
   protected:
-    std::deque<TP32Data> dq;
+    RingBuffer<time_t>   dqtime;       // reading columns
+    RingBuffer<int64_t>  dqmono;
+    RingBuffer<int32_t>  dqtemp;
+    RingBuffer<uint32_t> dqpress;
     unsigned int qcap;
+    int          qopts;
+    unsigned int inversions;   // neighbours whose time stamps decrease
 
     int32_t t_high, t_low;
     int32_t p_high, p_low;
     double  t_avg,  p_avg;
+    double  t_var,  p_var;
     bool    stale;
 
+    // Incremental mode (TP32Q_OPT_INCREMENTAL)
+    uint64_t  seqfront;              // sequence number of the front reading
+    uint64_t  seqnext;               // sequence number of the next push
+     int32_t  tref;                  // reference readings for the sums
+    uint32_t  pref;
+     int64_t  tsum, psum;            // sums of deviations from tref, pref
+     int64_t  tsq,  psq;             // sums of squared deviations
+    RingBuffer<TP32Extreme> tmaxq, tminq;
+    RingBuffer<TP32Extreme> pmaxq, pminq;
+
+    // Range mode (TP32Q_OPT_RANGE)
+    std::vector<TP32Aggregate>  rtree;   // rleaves leaves, from index rleaves
+    size_t                      rleaves;
+
+    // Snapshot mode (TP32Q_OPT_SNAPSHOT)
+    SeqLock<TP32Snapshot>  snap;
+
+    void  publish ();
+
+    void  track   ( const TP32Data& tpd );
+    void  untrack ();
+    void  resettrack ();
+
+    void  rangeset   ( size_t pos, const TP32Aggregate& leaf );
+    void  rangequery ( size_t lo, size_t hi, TP32Aggregate& acc );
+    void  rangescan  ( size_t lo, size_t hi, int32_t tr, uint32_t pr, TP32Aggregate& acc );
+
+    size_t    search  ( time_t t, bool after );
+    size_t    searchmono ( int64_t t, bool after );
+    int       rangesummary ( size_t lo, size_t hi, TP32Summary& temp, TP32Summary& press );
+    void      popfront ();
+    TP32Data  reading ( size_t i );
+
   public:
     std::mutex mtx;
 
-    TP32DataQueue ( int capacity=60 );
+    TP32DataQueue ( int capacity=60, int options=TP32Q_OPT_NONE );
 
     TP32Data back  ();
     TP32Data front ();
@@ -158,9 +363,11 @@ class TP32DataQueue
     int      push  ( TP32Data tpdata );
 
     int      capacity ();
+    int      options  ();
     void     clear ();
     bool     full  ();
     int      size  ();
+    bool     ordered ();
     void     summarize ();
 
     time_t   timestart ();
@@ -169,17 +376,26 @@ class TP32DataQueue
     int32_t  temperature_high();
     int32_t  temperature_low();
     double   temperature_average();
+    double   temperature_variance();
+    double   temperature_stddev();
 
-    int32_t  pressure_high();
-    int32_t  pressure_low();
+    uint32_t pressure_high();
+    uint32_t pressure_low();
     double   pressure_average();
+    double   pressure_variance();
+    double   pressure_stddev();
 
     TP32Summary  TemperatureSummary();
     TP32Summary  PressureSummary();
 
+    int          find ( time_t t );
+    int          RangeSummary ( time_t from, time_t to, TP32Summary& temp, TP32Summary& press );
+    int          MonoRangeSummary ( int64_t from, int64_t to, TP32Summary& temp, TP32Summary& press );
+
+    uint32_t     Snapshot ( TP32Snapshot& snapshot ) const;
+
 }; // class TP32DataQueue
 
 } // namespace bosch_bmp280
 
 #endif /* BMP280_DATA_HPP_ */
-```
@@ -108,12 +108,24 @@
 
 // Status Register (0xF3) Mask
 #define BMP280_STATUS_MSK    0x09  // 0000_1001
+#define BMP280_STATUS_MEAS   0x08  // 0000_1000  conversion running
+#define BMP280_STATUS_UPD    0x01  // 0000_0001  NVM data being copied
 
 // Reset
 #define BMP280_CMD_RESET     0xB6  // Reset command.
 #define BMP280_RESET_DELAY   3000  // Reset delay, in microseconds.
 #define BMP280_CONFIG_DELAY  8000  // Configuration delay, in microseconds.
 
+// Measurement Time*, in microseconds
+// * from BST-BMP280-DS001-19, section 3.8.1:
+//   t_max = 1.25 + 2.3*osrs_t + (2.3*osrs_p + 0.575) ms
+//   where the pressure term is dropped if pressure is skipped.
+#define BMP280_T_MEAS_BASE   1250  // fixed overhead
+#define BMP280_T_MEAS_OS     2300  // per oversampling step
+#define BMP280_T_MEAS_PRESS   575  // pressure enabled
+#define BMP280_T_MEAS_POLL    250  // status poll interval, if still measuring
+#define BMP280_T_MEAS_TRIES    20  // status polls before giving up
+
 
 
 // ctrl_meas Register (0xF4)
@@ -167,6 +179,7 @@
 
 // spi3w_en
 #define BMP280_SPI3W_MASK   0x01    // 000_000_01
+#define BMP280_SPI3W_MSK_OUT 0xFE   // 111_111_10
 #define BMP280_SPI3W_NDX       0
 
 
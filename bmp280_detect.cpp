@@ -0,0 +1,479 @@
+/*
+ * bmp280_detect.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Streaming event detection over a stream of readings.
+ *
+ *  Notes:
+ *    1. Smoothing is an exponential moving average with a gain of
+ *       dt/(tau + dt) for a reading dt after the last one: close to
+ *       1 - exp(-dt/tau) while dt is small against tau, and still
+ *       sensible (a gain near 1) across a long gap, without calling
+ *       exp() for every reading and rule.
+ *    2. Rate rules use the same gain for both the level and the trend
+ *       of Holt's method. The trend is updated from the change in the
+ *       smoothed level, so single noisy readings are damped twice.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <cmath>               // fabs()
+#include <stdexcept>           // runtime_error
+
+#include "bmp280_detect.hpp"   // TP32Detector
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+/*
+ * Smoothing gain for a reading dt after the last one.
+ */
+static inline double Gain(int64_t dt, int64_t tau)
+{
+    if (tau <= 0)
+        return 1.0;
+
+    return (double)dt / (double)(tau + dt);
+}
+
+
+// Class Public
+// -----------------------------------------------------------------
+
+/*
+ * TP32Detector::TP32Detector()
+ *
+ * Description:
+ *   Constructor. A detector with no rules.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+TP32Detector::TP32Detector()
+    : havelast(false), lasttime(0), events(0)
+{ }
+
+/*
+ * int TP32Detector::AddLevel(TP32Field field, double high, double low,
+ *                            TP32EventFn fn, unsigned int smooth)
+ *
+ * Description:
+ *   Adds a level rule: Above when the value reaches high, Below when
+ *   it falls to low.
+ *
+ * Parameters:
+ *   field  - the field to watch
+ *   high   - the Above threshold
+ *   low    - the Below threshold. Must be less than high.
+ *   fn     - called for each event
+ *   smooth - optional. Input smoothing time constant, milliseconds.
+ *            Default 0, none.
+ *
+ * Returns:
+ *   Returns the rule's index, as passed in TP32Event::rule.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if low is not less than high.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+int TP32Detector::AddLevel(TP32Field field, double high, double low,
+                           TP32EventFn fn, unsigned int smooth)
+{
+    if (!(low < high))
+    {
+        runtime_error re {"TP32Detector::AddLevel(): Low must be less than high."};
+        throw re;
+    }
+
+    Rule r;
+    r.kind  = Kind::Level;
+    r.field = field;
+    r.on    = high;
+    r.off   = low;
+    r.tau   = (int64_t)smooth * 1000000;
+    r.drift = 0;
+    r.fn    = fn;
+
+    return this->Add(r);
+}
+
+/*
+ * int TP32Detector::AddStep(TP32Field field, double step, TP32EventFn fn,
+ *                           unsigned int smooth, unsigned int drift)
+ *
+ * Description:
+ *   Adds a step rule: Step when the value has moved at least step
+ *   from its reference.
+ *
+ * Parameters:
+ *   field  - the field to watch
+ *   step   - the step size. Must be positive.
+ *   fn     - called for each event
+ *   smooth - optional. Input smoothing time constant, milliseconds.
+ *            Default 0, none.
+ *   drift  - optional. Time constant with which the reference follows
+ *            the value between events, milliseconds. It should be
+ *            long against the change being watched for. Default 0:
+ *            the reference only moves when the rule fires.
+ *
+ * Returns:
+ *   Returns the rule's index.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if step is not positive.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+int TP32Detector::AddStep(TP32Field field, double step, TP32EventFn fn,
+                          unsigned int smooth, unsigned int drift)
+{
+    if (!(step > 0.0))
+    {
+        runtime_error re {"TP32Detector::AddStep(): Step must be positive."};
+        throw re;
+    }
+
+    Rule r;
+    r.kind  = Kind::Step;
+    r.field = field;
+    r.on    = step;
+    r.off   = 0.0;
+    r.tau   = (int64_t)smooth * 1000000;
+    r.drift = (int64_t)drift  * 1000000;
+    r.fn    = fn;
+
+    return this->Add(r);
+}
+
+/*
+ * int TP32Detector::AddRate(TP32Field field, double on, double off,
+ *                           TP32EventFn fn, unsigned int smooth)
+ *
+ * Description:
+ *   Adds a rate rule: RateOn when the magnitude of the rate of change
+ *   reaches on, RateOff when it falls to off.
+ *
+ * Parameters:
+ *   field  - the field to watch
+ *   on     - RateOn threshold, units per second. Must be positive.
+ *   off    - RateOff threshold, units per second. At least zero, and
+ *            less than on.
+ *   fn     - called for each event
+ *   smooth - smoothing time constant, milliseconds. A rate taken
+ *            from consecutive readings alone is mostly noise, so
+ *            there is no default.
+ *
+ * Returns:
+ *   Returns the rule's index.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if the thresholds are out of order.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+int TP32Detector::AddRate(TP32Field field, double on, double off,
+                          TP32EventFn fn, unsigned int smooth)
+{
+    if (!(off >= 0.0 && off < on))
+    {
+        runtime_error re {"TP32Detector::AddRate(): Thresholds out of order."};
+        throw re;
+    }
+
+    Rule r;
+    r.kind  = Kind::Rate;
+    r.field = field;
+    r.on    = on;
+    r.off   = off;
+    r.tau   = (int64_t)smooth * 1000000;
+    r.drift = 0;
+    r.fn    = fn;
+
+    return this->Add(r);
+}
+
+/*
+ * int TP32Detector::Update(const TP32Data& reading)
+ *
+ * Description:
+ *   Runs every rule over one reading, calling back for each event
+ *   that fires.
+ *
+ * Parameters:
+ *   reading - the next reading, stamped
+ *
+ * Returns:
+ *   Returns the number of events fired.
+ *
+ * Exceptions:
+ *   Whatever a callback throws. The rules after it do not see the
+ *   reading.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+int TP32Detector::Update(const TP32Data& reading)
+{
+    int64_t dt = havelast ? reading.monotime - lasttime : 0;
+    if (dt < 0)
+        dt = 0;
+
+    if (!havelast || dt > 0)
+    {
+        lasttime = reading.monotime;
+        havelast = true;
+    }
+
+    uint64_t before = events;
+
+    for (size_t i = 0; i < rules.size(); i++)
+    {
+        Rule&  r = rules[i];
+        double v = (r.field == TP32Field::Pressure) ? (double)reading.pressure
+                                                    : (double)reading.temperature;
+
+        if (!r.primed)
+        {
+            r.primed = true;
+            r.x      = v;
+            r.ref    = v;
+            r.trend  = 0.0;
+        }
+        else if (r.kind == Kind::Rate)
+        {
+            if (dt > 0)
+            {
+                double g = Gain(dt, r.tau);
+                double x = r.x + r.trend*dt;
+
+                x += g*(v - x);
+                r.trend += g*((x - r.x)/dt - r.trend);
+                r.x = x;
+            }
+        }
+        else
+        {
+            r.x += (r.tau > 0) ? Gain(dt, r.tau)*(v - r.x) : (v - r.x);
+
+            if (r.drift > 0)
+                r.ref += Gain(dt, r.drift)*(r.x - r.ref);
+        }
+
+        switch (r.kind)
+        {
+            case Kind::Level:
+                if (r.state != 1 && r.x >= r.on)
+                {
+                    r.state = 1;
+                    this->Fire((int)i, TP32EventKind::Above, r.x - r.on, reading);
+                }
+                else if (r.state != -1 && r.x <= r.off)
+                {
+                    r.state = -1;
+                    this->Fire((int)i, TP32EventKind::Below, r.x - r.off, reading);
+                }
+                break;
+
+            case Kind::Step:
+                if (fabs(r.x - r.ref) >= r.on)
+                {
+                    double change = r.x - r.ref;
+
+                    r.ref = r.x;
+                    this->Fire((int)i, TP32EventKind::Step, change, reading);
+                }
+                break;
+
+            case Kind::Rate:
+            {
+                double rate = r.trend * 1e9;
+                int    sign = (rate < 0.0) ? -1 : 1;
+
+                // A reversal that skips the off band ends one event
+                // and starts another.
+                if (r.state != 0 && (fabs(rate) <= r.off || sign != r.state))
+                {
+                    r.state = 0;
+                    this->Fire((int)i, TP32EventKind::RateOff, rate, reading);
+                }
+                if (r.state == 0 && fabs(rate) >= r.on)
+                {
+                    r.state = sign;
+                    this->Fire((int)i, TP32EventKind::RateOn, rate, reading);
+                }
+                break;
+            }
+        }
+    }
+
+    return (int)(events - before);
+}
+
+/*
+ * void TP32Detector::Reset()
+ *
+ * Description:
+ *   Forgets every rule's state, keeping the rules. The next reading
+ *   primes them as the first one did: use this after a gap or a
+ *   device reconfiguration, where the stream does not carry on from
+ *   where it stopped.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+void TP32Detector::Reset()
+{
+    for (Rule& r : rules)
+    {
+        r.primed = false;
+        r.state  = 0;
+    }
+    havelast = false;
+}
+
+/*
+ * double TP32Detector::Value(int rule) const
+ *
+ * Description:
+ *   A rule's current (smoothed) value.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if rule is out of range.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+double TP32Detector::Value(int rule) const
+{
+    if (rule < 0 || rule >= (int)rules.size())
+    {
+        runtime_error re {"TP32Detector::Value(): No such rule."};
+        throw re;
+    }
+
+    return rules[rule].x;
+}
+
+/*
+ * double TP32Detector::Rate(int rule) const
+ *
+ * Description:
+ *   A rate rule's current rate of change, units per second; zero for
+ *   other rules.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if rule is out of range.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+double TP32Detector::Rate(int rule) const
+{
+    if (rule < 0 || rule >= (int)rules.size())
+    {
+        runtime_error re {"TP32Detector::Rate(): No such rule."};
+        throw re;
+    }
+
+    return (rules[rule].kind == Kind::Rate) ? rules[rule].trend * 1e9 : 0.0;
+}
+
+
+// Class Protected
+// -----------------------------------------------------------------
+
+/*
+ * int TP32Detector::Add(const Rule& r)
+ *
+ * Description:
+ *   Appends a rule, unprimed.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+int TP32Detector::Add(const Rule& r)
+{
+    rules.push_back(r);
+
+    Rule& added = rules.back();
+    added.primed = false;
+    added.state  = 0;
+    added.x      = 0.0;
+    added.ref    = 0.0;
+    added.trend  = 0.0;
+
+    return (int)rules.size() - 1;
+}
+
+/*
+ * void TP32Detector::Fire(int index, TP32EventKind kind, double change,
+ *                         const TP32Data& reading)
+ *
+ * Description:
+ *   Counts an event and hands it to the rule's callback, if it has
+ *   one.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+void TP32Detector::Fire(int index, TP32EventKind kind, double change, const TP32Data& reading)
+{
+    const Rule& r = rules[index];
+    events++;
+
+    if (!r.fn)
+        return;
+
+    TP32Event e;
+    e.rule    = index;
+    e.kind    = kind;
+    e.value   = r.x;
+    e.change  = change;
+    e.reading = reading;
+
+    r.fn(e);
+}
+
+} // namespace bosch_bmp280
@@ -0,0 +1,198 @@
+/*
+ * bmp280_detect.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Streaming event detection over a stream of readings: level
+ *    thresholds, steps and rates of change, with hysteresis.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_DETECT_HPP_
+#define BMP280_DETECT_HPP_
+
+#include <cstddef>           // size_t
+#include <functional>        // function
+#include <stdint.h>          // int64_t, uint64_t
+#include <vector>            // vector
+
+#include "bmp280_data.hpp"   // TP32Data
+
+namespace bosch_bmp280
+{
+
+// The reading field a rule watches. Values are in the reading's own
+// units: for 32-bit fixed-point compensation, hundredths of a degree
+// centigrade and pascals.
+enum class TP32Field
+{
+    Temperature, Pressure
+};
+
+// What fired.
+enum class TP32EventKind
+{
+    Above,          // level rule reached its high threshold
+    Below,          // level rule fell to its low threshold
+    Step,           // step rule moved a full step from its reference
+    RateOn,         // rate rule's rate reached its on threshold
+    RateOff         // ... and fell back to its off threshold
+};
+
+/*
+ * struct TP32Event
+ *
+ * Description:
+ *   One detected event, as handed to a rule's callback.
+ *
+ *   value is the rule's (smoothed) value when the event fired.
+ *   change depends on kind:
+ *     Above, Below     - value less the threshold crossed
+ *     Step             - value less the old reference
+ *     RateOn, RateOff  - the rate, units per second
+ *
+ *   reading is the reading that fired it.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+struct TP32Event
+{
+    int            rule;
+    TP32EventKind  kind;
+    double         value;
+    double         change;
+    TP32Data       reading;
+};
+
+typedef std::function<void(const TP32Event& event)> TP32EventFn;
+
+
+/*
+ * class TP32Detector
+ *
+ * Description:
+ *   Watches readings as they arrive and calls back only when a rule
+ *   fires, so that a consumer can wait on events instead of pushing
+ *   every reading into a TP32DataQueue and re-reading its summaries.
+ *   Update() costs O(1) per rule and never allocates.
+ *
+ *   Rules:
+ *
+ *     Level  - Above when the value reaches high, Below when it falls
+ *              to low. The band between is the hysteresis: once
+ *              Above has fired, Below is the only event that can
+ *              follow, and the other way round. A first reading
+ *              outside the band fires at once.
+ *
+ *     Step   - Step when the value has moved at least step from its
+ *              reference, which starts at the first reading and moves
+ *              to the value each time the rule fires. The next event
+ *              needs another full step, in either direction, so noise
+ *              around the boundary cannot chatter. With drift set,
+ *              the reference also follows the value with that time
+ *              constant, so weather changes far slower than the
+ *              change being watched for never add up to a step.
+ *
+ *     Rate   - the value and its rate of change are tracked by double
+ *              exponential (Holt) smoothing, with the rule's time
+ *              constant. RateOn fires when the rate's magnitude
+ *              reaches on, RateOff when it falls to off.
+ *
+ *   Level and Step rules can smooth their input too (an exponential
+ *   moving average; smooth 0 leaves it as read). Smoothing and rates
+ *   go by each reading's monotime, so readings must be stamped and in
+ *   order; a reading that is not later than the last one is counted
+ *   by the Level and Step rules but does not move a rate.
+ *
+ *   Presets 4 and 5 (bmp280_defs.hpp), for example:
+ *
+ *     TP32Detector det;
+ *
+ *     // floor changes: 3 m is about 36 Pa
+ *     det.AddStep(TP32Field::Pressure, 36.0, onfloor, 100, 60000);
+ *
+ *     // a fall: pressure climbing faster than 25 Pa/s
+ *     det.AddRate(TP32Field::Pressure, 25.0, 10.0, onfall, 100);
+ *
+ *     while (running)
+ *         det.Update(sensor.GetComp32FixedData());
+ *
+ *   Callbacks run on the thread that calls Update(), in rule order,
+ *   before it returns. One detector serves one sensor; it is not
+ *   thread safe.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_detect.hpp
+ */
+class TP32Detector
+{
+  protected:
+    enum class Kind { Level, Step, Rate };
+
+    struct Rule
+    {
+        Kind         kind;
+        TP32Field    field;
+        double       on;             // high, step or rate on
+        double       off;            // low, or rate off
+        int64_t      tau;            // smoothing time constant, ns
+        int64_t      drift;          // step reference time constant, ns
+        TP32EventFn  fn;
+
+        bool         primed;
+        int          state;          // -1 below/falling, 0 neither, +1 above/rising
+        double       x;              // smoothed value
+        double       ref;            // step reference
+        double       trend;          // rate, units per ns
+    };
+
+    std::vector<Rule>  rules;
+    bool      havelast;
+    int64_t   lasttime;
+    uint64_t  events;
+
+    int   Add  ( const Rule& r );
+    void  Fire ( int index, TP32EventKind kind, double change, const TP32Data& reading );
+
+  public:
+
+    TP32Detector ();
+
+    int   AddLevel ( TP32Field field, double high, double low, TP32EventFn fn,
+                     unsigned int smooth=0 );
+    int   AddStep  ( TP32Field field, double step, TP32EventFn fn,
+                     unsigned int smooth=0, unsigned int drift=0 );
+    int   AddRate  ( TP32Field field, double on, double off, TP32EventFn fn,
+                     unsigned int smooth );
+
+    int   Update ( const TP32Data& reading );
+    void  Reset  ();
+
+    size_t    size   () const { return rules.size(); }
+    uint64_t  Events () const { return events; }
+
+    double    Value ( int rule ) const;
+    double    Rate  ( int rule ) const;
+
+}; // class TP32Detector
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_DETECT_HPP_ */
@@ -0,0 +1,433 @@
+/*
+ * bmp280_engine.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Parallel acquisition from BMP280 devices on several I2C buses,
+ *    one worker thread per bus.
+ *
+ *  Notes:
+ *    1. Core pinning and SCHED_FIFO priorities use the pthread API
+ *       (Linux). Real-time priorities normally need CAP_SYS_NICE.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <chrono>            // steady_clock, microseconds
+#include <exception>         // exception
+#include <pthread.h>         // pthread_setaffinity_np(), pthread_setschedparam()
+#include <sched.h>           // cpu_set_t, SCHED_FIFO
+#include <stdexcept>         // runtime_error
+#include <thread>            // thread, this_thread::sleep_until()
+#include <unistd.h>          // usleep()
+
+#include "bmp280_engine.hpp" // BMP280Engine
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+// BMP280Engine Constructor, Destructor
+// -----------------------------------------------------------------
+
+/*
+ * BMP280Engine::BMP280Engine(int window, int options, size_t chancap)
+ *
+ * Description:
+ *   Constructor.
+ *
+ * Parameters:
+ *   window  - optional. Capacity of each sensor's TP32DataQueue.
+ *             The default is 60.
+ *   options - optional. TP32Q_OPT_ flags for the sensor windows.
+ *             The default is TP32Q_OPT_INCREMENTAL.
+ *   chancap - optional. Capacity of the aggregation channel, in
+ *             readings. The default is 1024.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+BMP280Engine::BMP280Engine(int window, int options, size_t chancap)
+    : channel(chancap), running(false), dropped(0), errors(0), unmapped(0)
+{
+    winsize = window;
+    winopts = options;
+}
+
+/*
+ * BMP280Engine::~BMP280Engine()
+ *
+ * Description:
+ *   Destructor. Stops all workers.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+BMP280Engine::~BMP280Engine()
+{
+    this->Stop();
+}
+
+
+// BMP280Engine Protected
+// -----------------------------------------------------------------
+
+/*
+ * void BMP280Engine::Run(Worker* w)
+ *
+ * Description:
+ *   Worker thread body. Cycles one bus scheduler until the engine is
+ *   stopped, pushing every reading into the aggregation channel.
+ *   Readings from devices the scheduler gained after AddBus() have
+ *   no sensor index, and are counted as unmapped instead.
+ *
+ *   A bus error ends the cycle it occurred in. It is counted, and
+ *   the worker carries on with the next cycle.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+void BMP280Engine::Run(Worker* w)
+{
+    auto sink = [this, w](int index, const TP32Data& reading)
+    {
+        if (index < 0 || index >= w->count)
+        {
+            unmapped++;
+            return;
+        }
+
+        TP32Sample sample { w->first + index, reading };
+        if (!channel.push(sample))
+            dropped++;
+    };
+
+    while (running.load(memory_order_relaxed))
+    {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        try
+        {
+            w->sched->Cycle(sink);
+        }
+        catch (exception&)
+        {
+            errors++;
+            usleep(BMP280_T_MEAS_POLL);
+        }
+
+        if (w->period > 0)
+            this_thread::sleep_until(start + chrono::microseconds(w->period));
+    }
+}
+
+/*
+ * void BMP280Engine::Pin(Worker* w)
+ *
+ * Description:
+ *   Applies a worker's core affinity and scheduling priority to its
+ *   thread.
+ *
+ *   Throws a runtime_error exception if either one is refused.
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+void BMP280Engine::Pin(Worker* w)
+{
+    pthread_t handle = w->thread.native_handle();
+
+    if (w->core >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(w->core, &cpus);
+
+        if (pthread_setaffinity_np(handle, sizeof(cpus), &cpus) != 0)
+        {
+            runtime_error re {"BMP280Engine::Start(): Unable to pin worker to core."};
+            throw re;
+        }
+    }
+
+    if (w->priority > 0)
+    {
+        sched_param sp;
+        sp.sched_priority = w->priority;
+
+        if (pthread_setschedparam(handle, SCHED_FIFO, &sp) != 0)
+        {
+            runtime_error re {"BMP280Engine::Start(): Unable to set worker priority."};
+            throw re;
+        }
+    }
+}
+
+
+// BMP280Engine Public
+// -----------------------------------------------------------------
+
+/*
+ * int BMP280Engine::AddBus(BMP280BusScheduler* sched, int core,
+ *                          int priority, unsigned int period)
+ *
+ * Description:
+ *   Adds a bus to the engine. Its devices get consecutive sensor
+ *   indexes, in the order they were added to the scheduler, and one
+ *   TP32DataQueue window each. Only the devices the scheduler holds
+ *   now are given indexes: add every device before the bus.
+ *
+ *   Throws a runtime_error exception if the engine is running.
+ *
+ * Parameters:
+ *   sched    - the bus scheduler. Must outlive the engine.
+ *   core     - optional. CPU core to pin the worker to, or -1 (the
+ *              default) to leave it unpinned.
+ *   priority - optional. SCHED_FIFO priority (1..99), or 0 (the
+ *              default) for normal scheduling.
+ *   period   - optional. Minimum microseconds per cycle, to limit
+ *              the sample rate. The default, 0, runs flat out.
+ *
+ * Returns:
+ *   Returns the sensor index of the scheduler's first device.
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+int BMP280Engine::AddBus(BMP280BusScheduler* sched, int core, int priority, unsigned int period)
+{
+    if (running)
+    {
+        runtime_error re {"BMP280Engine::AddBus(): The engine is running."};
+        throw re;
+    }
+
+    unique_ptr<Worker> w { new Worker };
+    w->sched    = sched;
+    w->first    = (int)windows.size();
+    w->count    = sched->size();
+    w->core     = core;
+    w->priority = priority;
+    w->period   = period;
+
+    for (int i = 0; i < w->count; i++)
+        windows.push_back(unique_ptr<TP32DataQueue>{ new TP32DataQueue(winsize, winopts) });
+
+    int first = w->first;
+    workers.push_back(move(w));
+
+    return first;
+}
+
+/*
+ * void BMP280Engine::Start()
+ *
+ * Description:
+ *   Starts one worker thread per bus. Does nothing if the engine is
+ *   already running.
+ *
+ *   Throws a runtime_error exception, after stopping any workers
+ *   already started, if a core or priority cannot be applied.
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+void BMP280Engine::Start()
+{
+    if (running.exchange(true))
+        return;
+
+    try
+    {
+        for (auto& w : workers)
+        {
+            w->thread = thread(&BMP280Engine::Run, this, w.get());
+            this->Pin(w.get());
+        }
+    }
+    catch (...)
+    {
+        this->Stop();
+        throw;
+    }
+}
+
+/*
+ * void BMP280Engine::Stop()
+ *
+ * Description:
+ *   Stops all worker threads and waits for them to finish their
+ *   current cycle. Readings already in the channel can still be
+ *   drained.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+void BMP280Engine::Stop()
+{
+    running = false;
+
+    for (auto& w : workers)
+    {
+        if (w->thread.joinable())
+            w->thread.join();
+    }
+}
+
+/*
+ * int BMP280Engine::Drain(function<void(const TP32Sample&)> sink)
+ *
+ * Description:
+ *   Moves every reading currently in the aggregation channel into
+ *   its sensor's window. Never blocks. A reading whose sensor index
+ *   has no window is discarded and counted as unmapped.
+ *
+ * Parameters:
+ *   sink - optional. Also called with each reading, after it has
+ *          been pushed to its window.
+ *
+ * Returns:
+ *   Returns the number of readings drained.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+int BMP280Engine::Drain(function<void(const TP32Sample&)> sink)
+{
+    TP32Sample sample;
+    int count = 0;
+
+    while (channel.pop(sample))
+    {
+        if (sample.sensor < 0 || sample.sensor >= (int)windows.size())
+        {
+            unmapped++;
+            continue;
+        }
+
+        windows[sample.sensor]->push(sample.reading);
+        if (sink)
+            sink(sample);
+        count++;
+    }
+
+    return count;
+}
+
+/*
+ * TP32DataQueue& BMP280Engine::Window(int sensor)
+ *
+ * Description:
+ *   Retrieves a sensor's window. Only the thread that calls Drain()
+ *   should touch it.
+ *
+ *   Throws a runtime_error exception if there is no such sensor.
+ *
+ * Parameters:
+ *   sensor - a sensor index
+ *
+ * Returns:
+ *   Returns a reference to the sensor's TP32DataQueue.
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+TP32DataQueue& BMP280Engine::Window(int sensor)
+{
+    if (sensor < 0 || sensor >= (int)windows.size())
+    {
+        runtime_error re {"BMP280Engine::Window(): No such sensor."};
+        throw re;
+    }
+
+    return *windows[sensor];
+}
+
+
+/*
+ * uint32_t BMP280Engine::Snapshot(int sensor, TP32Snapshot& snapshot) const
+ *
+ * Description:
+ *   Copies the latest published summaries of a sensor's window. Any
+ *   thread may call it, once all buses have been added; it takes no
+ *   lock and does not disturb Drain().
+ *
+ *   The windows must have been created with TP32Q_OPT_SNAPSHOT (see
+ *   the constructor), or the snapshot holds zeroes.
+ *
+ *   Throws a runtime_error exception if there is no such sensor.
+ *
+ * Parameters:
+ *   sensor   - a sensor index
+ *   snapshot - receives the summaries
+ *
+ * Returns:
+ *   Returns the window's publication count (see
+ *   TP32DataQueue::Snapshot()).
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+uint32_t BMP280Engine::Snapshot(int sensor, TP32Snapshot& snapshot) const
+{
+    if (sensor < 0 || sensor >= (int)windows.size())
+    {
+        runtime_error re {"BMP280Engine::Snapshot(): No such sensor."};
+        throw re;
+    }
+
+    return windows[sensor]->Snapshot(snapshot);
+}
+
+} // namespace bosch_bmp280
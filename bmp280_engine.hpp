@@ -0,0 +1,145 @@
+/*
+ * bmp280_engine.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Parallel acquisition from BMP280 devices on several I2C buses,
+ *    one worker thread per bus.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_ENGINE_HPP_
+#define BMP280_ENGINE_HPP_
+
+#include <atomic>            // atomic
+#include <functional>        // function
+#include <memory>            // unique_ptr
+#include <stdint.h>          // uint32_t, uint64_t
+#include <thread>            // thread
+#include <vector>            // vector
+
+#include "bmp280_channel.hpp"  // MPSCChannel
+#include "bmp280_data.hpp"     // TP32Data, TP32DataQueue, TP32Snapshot
+#include "bmp280_sched.hpp"    // BMP280BusScheduler
+
+namespace bosch_bmp280
+{
+
+/*
+ * struct TP32Sample
+ *
+ * Description:
+ *   A reading tagged with the engine-wide index of the sensor that
+ *   produced it.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+struct TP32Sample
+{
+    int       sensor;
+    TP32Data  reading;
+};
+
+
+/*
+ * class BMP280Engine
+ *
+ * Description:
+ *   Runs one acquisition worker per bus, each driving that bus's
+ *   BMP280BusScheduler in a loop, so that throughput grows with the
+ *   number of buses instead of being serialized behind one thread.
+ *
+ *   Workers can be pinned to a CPU core and given a real-time
+ *   (SCHED_FIFO) priority.
+ *
+ *   Every reading is pushed, tagged with its sensor index, into one
+ *   lock-free MPSCChannel. The consumer side, Drain(), moves readings
+ *   from the channel into one TP32DataQueue window per sensor, and
+ *   optionally hands each one to a callback. Drain() must only be
+ *   called from one thread at a time; the windows belong to that
+ *   thread.
+ *
+ *   If the channel is full, the reading is dropped and counted
+ *   rather than blocking the worker.
+ *
+ *   Each bus's sensor indexes are fixed when AddBus() is called. A
+ *   device added to its scheduler after that has no index or window;
+ *   its readings are dropped and counted as Unmapped().
+ *
+ *   With TP32Q_OPT_SNAPSHOT in the window options, other threads (an
+ *   HTTP exporter, say) can read each window's summaries through
+ *   Snapshot() without going near the Drain() thread.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_engine.hpp
+ */
+class BMP280Engine
+{
+  protected:
+    struct Worker
+    {
+        BMP280BusScheduler*  sched;
+        int                  first;      // sensor index of sched device 0
+        int                  count;      // sched devices given indexes
+        int                  core;       // -1: not pinned
+        int                  priority;   //  0: normal scheduling
+        unsigned int         period;     // minimum microseconds per cycle
+        std::thread          thread;
+    };
+
+    std::vector< std::unique_ptr<Worker> >         workers;
+    std::vector< std::unique_ptr<TP32DataQueue> >  windows;
+    MPSCChannel<TP32Sample>  channel;
+    int                      winsize;
+    int                      winopts;
+
+    std::atomic<bool>      running;
+    std::atomic<uint64_t>  dropped;
+    std::atomic<uint64_t>  errors;
+    std::atomic<uint64_t>  unmapped;
+
+    void  Run  ( Worker* w );
+    void  Pin  ( Worker* w );
+
+  public:
+
+    BMP280Engine ( int window=60, int options=TP32Q_OPT_INCREMENTAL, size_t chancap=1024 );
+    ~BMP280Engine ();
+
+    int   AddBus ( BMP280BusScheduler* sched, int core=-1, int priority=0, unsigned int period=0 );
+
+    void  Start ();
+    void  Stop  ();
+
+    int   Drain ( std::function<void(const TP32Sample&)> sink=nullptr );
+
+    int             sensors  () const { return (int)windows.size(); }
+    TP32DataQueue&  Window   ( int sensor );
+    uint32_t        Snapshot ( int sensor, TP32Snapshot& snapshot ) const;
+
+    uint64_t  Dropped  () const { return dropped.load();  }
+    uint64_t  Errors   () const { return errors.load();   }
+    uint64_t  Unmapped () const { return unmapped.load(); }
+
+}; // class BMP280Engine
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_ENGINE_HPP_ */
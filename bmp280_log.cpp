@@ -0,0 +1,659 @@
+/*
+ * bmp280_log.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Compact binary log of raw and compensated BMP280 readings.
+ *
+ *  Notes:
+ *    1. The writer appends to an existing log. Blocks decode on their
+ *       own, so the only fix-up is cutting off a partial last block,
+ *       and the file header is only written to an empty file.
+ *    2. The reader never trusts a length it has not checked against
+ *       the size of the mapping, or a payload that fails its CRC.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <cstdio>            // fdopen(), fwrite(), fflush(), fclose()
+#include <cstring>           // memcpy(), memcmp()
+#include <fcntl.h>           // open()
+#include <stdexcept>         // runtime_error
+#include <sys/mman.h>        // mmap(), munmap(), madvise()
+#include <sys/stat.h>        // fstat()
+#include <unistd.h>          // close(), pread(), ftruncate()
+
+#include "bmp280_log.hpp"    // BMP280LogWriter, BMP280LogReader
+#include "bmp280_varint.hpp" // PutVarint(), GetVarint(), ZigZag()
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+static const char logmagic[8] = { 'B','M','P','2','8','0','L','G' };
+
+/*
+ * CRC-32 (IEEE 802.3, reflected, as BMP280CalCache::Crc32()), by
+ * table, since it sees every byte of every block.
+ */
+static uint32_t Crc32(const uint8_t* data, size_t len)
+{
+    static const struct Table
+    {
+        uint32_t t[256];
+
+        Table()
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t c = i;
+                for (int b = 0; b < 8; b++)
+                    c = (c >> 1) ^ (0xEDB88320 & (0 - (c & 1)));
+                t[i] = c;
+            }
+        }
+    } table;
+
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (size_t i = 0; i < len; i++)
+        crc = (crc >> 8) ^ table.t[(crc ^ data[i]) & 0xFF];
+
+    return ~crc;
+}
+
+
+// BMP280LogWriter Constructor, Destructor
+// -----------------------------------------------------------------
+
+/*
+ * BMP280LogWriter::BMP280LogWriter(const string& path, const uint8_t* calraw,
+ *                                  uint32_t recsperblock)
+ *
+ * Description:
+ *   Constructor. Opens a log for append, creating it if necessary.
+ *   An existing log is cut back to the end of its last whole block
+ *   (see Recover()).
+ *
+ * Parameters:
+ *   path         - the log file
+ *   calraw       - calibration ROM image of the sensor being logged
+ *                  (see BMP280::GetCalRaw())
+ *   recsperblock - optional. Records per block. The default is
+ *                  BMP280_LOG_BLOCK_RECS.
+ *
+ * Exceptions:
+ *   Throws runtime_error if the file cannot be opened or written, or
+ *   is not a BMP280 log.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_log.hpp
+ */
+BMP280LogWriter::BMP280LogWriter(const string& path, const uint8_t* calraw, uint32_t recsperblock)
+{
+    count     = 0;
+    blockrecs = (recsperblock > 0) ? recsperblock : 1;
+    memcpy(cal, calraw, BMP280_CAL_SIZE);
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        runtime_error re {"BMP280LogWriter::BMP280LogWriter(): Cannot open log file."};
+        throw re;
+    }
+
+    try
+    {
+        this->Recover(fd);
+    }
+    catch (...)
+    {
+        close(fd);
+        throw;
+    }
+
+    fp = fdopen(fd, "r+b");
+    if (fp == nullptr || fseek(fp, 0, SEEK_END) != 0)
+    {
+        if (fp != nullptr)
+            fclose(fp);
+        else
+            close(fd);
+        runtime_error re {"BMP280LogWriter::BMP280LogWriter(): Cannot open log file."};
+        throw re;
+    }
+
+    if (ftell(fp) == 0)
+    {
+        uint8_t hdr[BMP280_LOG_FILE_HDR] {0};
+        memcpy(hdr, logmagic, 8);
+        Put32(hdr + 8, BMP280_LOG_VERSION);
+
+        if (fwrite(hdr, 1, sizeof(hdr), fp) != sizeof(hdr))
+        {
+            fclose(fp);
+            runtime_error re {"BMP280LogWriter::BMP280LogWriter(): Cannot write log file."};
+            throw re;
+        }
+    }
+
+    block.reserve(BMP280_LOG_BLOCK_HDR + (size_t)blockrecs * 5 * 3);
+}
+
+/*
+ * BMP280LogWriter::~BMP280LogWriter()
+ *
+ * Description:
+ *   Destructor. Writes any buffered records and closes the log.
+ *   Errors are ignored here: call Close() to see them.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_log.hpp
+ */
+BMP280LogWriter::~BMP280LogWriter()
+{
+    try
+    {
+        this->Close();
+    }
+    catch (...)
+    { }
+}
+
+
+// BMP280LogWriter Protected
+// -----------------------------------------------------------------
+
+/*
+ * void BMP280LogWriter::StartBlock(int64_t t0)
+ *
+ * Description:
+ *   Starts a new block, with room reserved for its header, and
+ *   resets the delta state.
+ *
+ * Parameters:
+ *   t0 - time stamp of the block's first record
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_log.hpp
+ */
+void BMP280LogWriter::StartBlock(int64_t t0)
+{
+    block.assign(BMP280_LOG_BLOCK_HDR, 0);
+    Put64(&block[16], (uint64_t)t0);
+
+    prev.timestamp   = t0;
+    prev.rawtemp     = 0;
+    prev.rawpress    = 0;
+    prev.temperature = 0;
+    prev.pressure    = 0;
+}
+
+
+/*
+ * void BMP280LogWriter::Recover(int fd)
+ *
+ * Description:
+ *   Walks the blocks of an existing log, with the checks the reader
+ *   makes, and truncates the file at the end of the last whole one.
+ *   A writer that was killed mid-block leaves a partial block at the
+ *   end; left in place, its length field would run into the first
+ *   block appended after it, and the reader would decode that as
+ *   records. An empty file, or a partial file header, is cut to zero
+ *   length for the constructor to start afresh.
+ *
+ * Parameters:
+ *   fd - the log, open for reading and writing
+ *
+ * Exceptions:
+ *   Throws runtime_error if the file is not a BMP280 log, or cannot
+ *   be read or truncated.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_log.hpp
+ */
+void BMP280LogWriter::Recover(int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        runtime_error re {"BMP280LogWriter::Recover(): Cannot read log file."};
+        throw re;
+    }
+
+    size_t  size = (size_t)st.st_size;
+    size_t  good = 0;
+    uint8_t hdr[BMP280_LOG_BLOCK_HDR];
+
+    if (size < BMP280_LOG_FILE_HDR)
+    {
+        size_t n = (size < 8) ? size : 8;
+        if (pread(fd, hdr, n, 0) != (ssize_t)n || memcmp(hdr, logmagic, n) != 0)
+        {
+            runtime_error re {"BMP280LogWriter::Recover(): Not a BMP280 log."};
+            throw re;
+        }
+    }
+    else
+    {
+        if (pread(fd, hdr, BMP280_LOG_FILE_HDR, 0) != BMP280_LOG_FILE_HDR ||
+            memcmp(hdr, logmagic, 8) != 0 ||
+            Get32(hdr + 8) < 1 || Get32(hdr + 8) > BMP280_LOG_VERSION)
+        {
+            runtime_error re {"BMP280LogWriter::Recover(): Not a BMP280 log."};
+            throw re;
+        }
+
+        bool            check = (Get32(hdr + 8) >= 2);
+        vector<uint8_t> payload;
+
+        good = BMP280_LOG_FILE_HDR;
+        while (size - good >= BMP280_LOG_BLOCK_HDR)
+        {
+            if (pread(fd, hdr, BMP280_LOG_BLOCK_HDR, (off_t)good) != BMP280_LOG_BLOCK_HDR ||
+                Get32(hdr) != BMP280_LOG_BLOCK_MAGIC)
+                break;
+
+            uint32_t length = Get32(hdr + 8);
+            if (length > size - good - BMP280_LOG_BLOCK_HDR)
+                break;
+
+            if (check)
+            {
+                payload.resize(length);
+                if (pread(fd, payload.data(), length, (off_t)(good + BMP280_LOG_BLOCK_HDR)) != (ssize_t)length ||
+                    Crc32(payload.data(), length) != Get32(hdr + 12))
+                    break;
+            }
+
+            good += BMP280_LOG_BLOCK_HDR + length;
+        }
+    }
+
+    if (good < size && ftruncate(fd, (off_t)good) != 0)
+    {
+        runtime_error re {"BMP280LogWriter::Recover(): Cannot truncate log file."};
+        throw re;
+    }
+}
+
+
+// BMP280LogWriter Public
+// -----------------------------------------------------------------
+
+/*
+ * void BMP280LogWriter::SetCalRaw(const uint8_t* calraw)
+ *
+ * Description:
+ *   Changes the calibration recorded with subsequent records. Any
+ *   buffered records are written first, under the old calibration.
+ *
+ * Parameters:
+ *   calraw - calibration ROM image
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_log.hpp
+ */
+void BMP280LogWriter::SetCalRaw(const uint8_t* calraw)
+{
+    if (memcmp(cal, calraw, BMP280_CAL_SIZE) == 0)
+        return;
+
+    this->Flush();
+    memcpy(cal, calraw, BMP280_CAL_SIZE);
+}
+
+/*
+ * void BMP280LogWriter::Write(const TP32Data& raw, const TP32Data& comp)
+ *
+ * Description:
+ *   Appends one record. The time stamp is taken from raw.
+ *
+ * Parameters:
+ *   raw  - the uncompensated reading
+ *   comp - the same reading, compensated
+ *
+ * Exceptions:
+ *   Throws runtime_error if a full block cannot be written.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_log.hpp
+ */
+void BMP280LogWriter::Write(const TP32Data& raw, const TP32Data& comp)
+{
+    if (count == 0)
+        this->StartBlock((int64_t)raw.timestamp);
+
+    size_t  at = block.size();
+    block.resize(at + 5*BMP280_VARINT_MAX);
+
+    uint8_t* p = &block[at];
+    p = PutVarint(p, ZigZag((int64_t)raw.timestamp - prev.timestamp));
+    p = PutVarint(p, ZigZag((int64_t)raw.temperature  - prev.rawtemp));
+    p = PutVarint(p, ZigZag((int64_t)raw.pressure     - prev.rawpress));
+    p = PutVarint(p, ZigZag((int64_t)comp.temperature - prev.temperature));
+    p = PutVarint(p, ZigZag((int64_t)comp.pressure    - prev.pressure));
+    block.resize(p - &block[0]);
+
+    prev.timestamp   = (int64_t)raw.timestamp;
+    prev.rawtemp     = raw.temperature;
+    prev.rawpress    = raw.pressure;
+    prev.temperature = comp.temperature;
+    prev.pressure    = comp.pressure;
+
+    if (++count >= blockrecs)
+        this->Flush();
+}
+
+/*
+ * void BMP280LogWriter::Flush()
+ *
+ * Description:
+ *   Writes the buffered records as a block, and flushes the stream.
+ *   Does nothing if no records are buffered.
+ *
+ * Exceptions:
+ *   Throws runtime_error if the block cannot be written.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_log.hpp
+ */
+void BMP280LogWriter::Flush()
+{
+    if (count == 0 || fp == nullptr)
+        return;
+
+    uint8_t* hdr = &block[0];
+    Put32(hdr + 0, BMP280_LOG_BLOCK_MAGIC);
+    Put32(hdr + 4, count);
+    Put32(hdr + 8, (uint32_t)(block.size() - BMP280_LOG_BLOCK_HDR));
+    Put32(hdr + 12, Crc32(hdr + BMP280_LOG_BLOCK_HDR, block.size() - BMP280_LOG_BLOCK_HDR));
+    memcpy(hdr + 24, cal, BMP280_CAL_SIZE);
+
+    count = 0;
+
+    if (fwrite(hdr, 1, block.size(), fp) != block.size() || fflush(fp) != 0)
+    {
+        runtime_error re {"BMP280LogWriter::Flush(): Cannot write log file."};
+        throw re;
+    }
+}
+
+/*
+ * void BMP280LogWriter::Close()
+ *
+ * Description:
+ *   Writes any buffered records and closes the log.
+ *
+ * Exceptions:
+ *   Throws runtime_error if the last block cannot be written.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_log.hpp
+ */
+void BMP280LogWriter::Close()
+{
+    if (fp == nullptr)
+        return;
+
+    FILE* f = fp;
+    try
+    {
+        this->Flush();
+    }
+    catch (...)
+    {
+        fclose(f);
+        fp = nullptr;
+        throw;
+    }
+
+    fclose(f);
+    fp = nullptr;
+}
+
+
+// BMP280LogReader Constructor, Destructor
+// -----------------------------------------------------------------
+
+/*
+ * BMP280LogReader::BMP280LogReader(const string& path)
+ *
+ * Description:
+ *   Constructor. Maps a log read-only and checks its file header.
+ *
+ * Parameters:
+ *   path - the log file
+ *
+ * Exceptions:
+ *   Throws runtime_error if the file cannot be mapped or is not a
+ *   BMP280 log.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_log.hpp
+ */
+BMP280LogReader::BMP280LogReader(const string& path)
+{
+    base    = nullptr;
+    len     = 0;
+    version = 0;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        runtime_error re {"BMP280LogReader::BMP280LogReader(): Cannot open log file."};
+        throw re;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < BMP280_LOG_FILE_HDR)
+    {
+        close(fd);
+        runtime_error re {"BMP280LogReader::BMP280LogReader(): Not a BMP280 log."};
+        throw re;
+    }
+
+    void* m = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED)
+    {
+        runtime_error re {"BMP280LogReader::BMP280LogReader(): Cannot map log file."};
+        throw re;
+    }
+
+    base = (const uint8_t*)m;
+    len  = (size_t)st.st_size;
+    madvise(m, len, MADV_SEQUENTIAL);
+
+    version = Get32(base + 8);
+    if (memcmp(base, logmagic, 8) != 0 || version < 1 || version > BMP280_LOG_VERSION)
+    {
+        munmap(m, len);
+        runtime_error re {"BMP280LogReader::BMP280LogReader(): Not a BMP280 log."};
+        throw re;
+    }
+
+    this->Rewind();
+}
+
+/*
+ * BMP280LogReader::~BMP280LogReader()
+ *
+ * Description:
+ *   Destructor. Unmaps the log.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_log.hpp
+ */
+BMP280LogReader::~BMP280LogReader()
+{
+    if (base != nullptr)
+        munmap((void*)base, len);
+}
+
+
+// BMP280LogReader Protected
+// -----------------------------------------------------------------
+
+/*
+ * bool BMP280LogReader::OpenBlock(const uint8_t* hdr)
+ *
+ * Description:
+ *   Makes the block at hdr the current block, if it is complete and,
+ *   from version 2, its payload matches its CRC.
+ *
+ * Parameters:
+ *   hdr - where the block header should be
+ *
+ * Returns:
+ *   Returns false at the end of the log, or at a block that is
+ *   truncated or damaged.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_log.hpp
+ */
+bool BMP280LogReader::OpenBlock(const uint8_t* hdr)
+{
+    size_t avail = len - (size_t)(hdr - base);
+
+    if (avail < BMP280_LOG_BLOCK_HDR || Get32(hdr) != BMP280_LOG_BLOCK_MAGIC)
+        return false;
+
+    uint32_t length = Get32(hdr + 8);
+    if (length > avail - BMP280_LOG_BLOCK_HDR)
+        return false;
+
+    if (version >= 2 && Crc32(hdr + BMP280_LOG_BLOCK_HDR, length) != Get32(hdr + 12))
+        return false;
+
+    blk  = hdr;
+    pos  = hdr + BMP280_LOG_BLOCK_HDR;
+    end  = pos + length;
+    left = Get32(hdr + 4);
+
+    prev.timestamp   = (int64_t)Get64(hdr + 16);
+    prev.rawtemp     = 0;
+    prev.rawpress    = 0;
+    prev.temperature = 0;
+    prev.pressure    = 0;
+
+    return true;
+}
+
+
+// BMP280LogReader Public
+// -----------------------------------------------------------------
+
+/*
+ * bool BMP280LogReader::Next(TP32LogRecord& rec)
+ *
+ * Description:
+ *   Decodes the next record.
+ *
+ * Parameters:
+ *   rec - receives the record
+ *
+ * Returns:
+ *   Returns false at the end of the log.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_log.hpp
+ */
+bool BMP280LogReader::Next(TP32LogRecord& rec)
+{
+    while (left == 0)
+    {
+        const uint8_t* hdr = (blk != nullptr) ? end : base + BMP280_LOG_FILE_HDR;
+        if (!this->OpenBlock(hdr))
+            return false;
+    }
+
+    uint64_t d[5];
+    const uint8_t* p = pos;
+    for (int i = 0; i < 5; i++)
+    {
+        p = GetVarint(p, end, d[i]);
+        if (p == nullptr)
+        {
+            left = 0;
+            end  = base + len;       // damaged block: stop here
+            return false;
+        }
+    }
+
+    prev.timestamp  += UnZigZag(d[0]);
+    prev.rawtemp     = (int32_t) ((int64_t)prev.rawtemp     + UnZigZag(d[1]));
+    prev.rawpress    = (uint32_t)((int64_t)prev.rawpress    + UnZigZag(d[2]));
+    prev.temperature = (int32_t) ((int64_t)prev.temperature + UnZigZag(d[3]));
+    prev.pressure    = (uint32_t)((int64_t)prev.pressure    + UnZigZag(d[4]));
+
+    pos = p;
+    left--;
+    rec = prev;
+
+    return true;
+}
+
+/*
+ * void BMP280LogReader::Rewind()
+ *
+ * Description:
+ *   Goes back to the first record.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_log.hpp
+ */
+void BMP280LogReader::Rewind()
+{
+    blk  = nullptr;
+    pos  = nullptr;
+    end  = nullptr;
+    left = 0;
+}
+
+} // namespace bosch_bmp280
@@ -0,0 +1,195 @@
+/*
+ * bmp280_log.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Compact binary log of raw and compensated BMP280 readings, with
+ *    a memory-mapped reader for replay.
+ *
+ *  File Layout:
+ *    File header, 16 bytes:
+ *      "BMP280LG", uint32 version, uint32 reserved
+ *
+ *    Then any number of blocks. Block header, 48 bytes:
+ *      uint32 magic     BMP280_LOG_BLOCK_MAGIC
+ *      uint32 count     records in the block
+ *      uint32 length    payload bytes after the header
+ *      uint32 crc       CRC-32 of the payload (version 1: zero)
+ *      int64  t0        time stamp the first delta is taken from
+ *      uint8  cal[24]   calibration ROM image (see BMP280::GetCalRaw())
+ *
+ *    Block payload, one record after another. Each record is five
+ *    zigzag varints (see bmp280_varint.hpp), each the difference from
+ *    the previous record in the block:
+ *      timestamp, raw temperature, raw pressure,
+ *      compensated temperature, compensated pressure
+ *
+ *    The first record of a block is a difference from t0 and zeroes,
+ *    so every block decodes on its own. A typical record at one reading
+ *    per second is five to eight bytes.
+ *
+ *    Fixed-width fields are little-endian.
+ *
+ *    Version 1 logs carry no payload CRC; they are still read, and
+ *    appended to, without one being checked.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_LOG_HPP_
+#define BMP280_LOG_HPP_
+
+#include <cstddef>           // size_t
+#include <cstdio>            // FILE
+#include <stdint.h>          // uint8_t, uint32_t, int64_t
+#include <string>            // string
+#include <vector>            // vector
+
+#include "bmp280_data.hpp"   // TP32Data
+#include "bmp280_defs.hpp"   // BMP280_CAL_SIZE
+
+namespace bosch_bmp280
+{
+
+#define BMP280_LOG_VERSION       2
+#define BMP280_LOG_FILE_HDR     16
+#define BMP280_LOG_BLOCK_HDR    48
+#define BMP280_LOG_BLOCK_MAGIC  0x4B4C4250    // "PBLK"
+#define BMP280_LOG_BLOCK_RECS   4096          // default records per block
+
+
+/*
+ * struct TP32LogRecord
+ *
+ * Description:
+ *   One decoded log record: a raw reading and its compensated value.
+ *   The two share a time stamp.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_log.hpp
+ */
+struct TP32LogRecord
+{
+    int64_t   timestamp;
+    int32_t   rawtemp;
+    uint32_t  rawpress;
+    int32_t   temperature;
+    uint32_t  pressure;
+};
+
+
+/*
+ * class BMP280LogWriter
+ *
+ * Description:
+ *   Appends readings to a binary log. Records are encoded into an
+ *   in-memory block, and each block goes to the file with a single
+ *   write once it holds blockrecs records, when the calibration
+ *   changes, or on Flush().
+ *
+ *   Opening an existing log first walks its blocks and cuts it back
+ *   to the end of the last whole one, so that records appended after
+ *   a crash are not buried behind a partial block.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_log.hpp
+ */
+class BMP280LogWriter
+{
+  protected:
+    FILE*                 fp;
+    std::vector<uint8_t>  block;      // header space + payload
+    uint32_t              count;
+    uint32_t              blockrecs;
+    uint8_t               cal[BMP280_CAL_SIZE];
+    TP32LogRecord         prev;
+
+    void  StartBlock ( int64_t t0 );
+    void  Recover    ( int fd );
+
+  public:
+
+    BMP280LogWriter ( const std::string& path, const uint8_t* calraw,
+                      uint32_t recsperblock=BMP280_LOG_BLOCK_RECS );
+    ~BMP280LogWriter ();
+
+    BMP280LogWriter ( const BMP280LogWriter& ) = delete;
+    BMP280LogWriter& operator= ( const BMP280LogWriter& ) = delete;
+
+    void  SetCalRaw ( const uint8_t* calraw );
+    void  Write     ( const TP32Data& raw, const TP32Data& comp );
+    void  Flush     ();
+    void  Close     ();
+
+}; // class BMP280LogWriter
+
+
+/*
+ * class BMP280LogReader
+ *
+ * Description:
+ *   Reads a binary log through a read-only memory mapping. Next()
+ *   decodes records straight out of the mapping, so nothing is read
+ *   or copied that is not being decoded, and replay runs at the
+ *   speed of the varint decoder.
+ *
+ *   A truncated or damaged block (from a writer that did not finish,
+ *   say) ends the log at the last whole block. From version 2 each
+ *   block's payload is checked against its CRC before any record in
+ *   it is decoded.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_log.hpp
+ */
+class BMP280LogReader
+{
+  protected:
+    const uint8_t*  base;
+    size_t          len;
+    uint32_t        version;
+
+    const uint8_t*  blk;         // current block header, or nullptr
+    const uint8_t*  pos;         // next record
+    const uint8_t*  end;         // end of the current block payload
+    uint32_t        left;        // records left in the current block
+    TP32LogRecord   prev;
+
+    bool  OpenBlock ( const uint8_t* hdr );
+
+  public:
+
+    BMP280LogReader ( const std::string& path );
+    ~BMP280LogReader ();
+
+    BMP280LogReader ( const BMP280LogReader& ) = delete;
+    BMP280LogReader& operator= ( const BMP280LogReader& ) = delete;
+
+    bool  Next   ( TP32LogRecord& rec );
+    void  Rewind ();
+
+    // Calibration ROM image of the block the last record came from.
+    const uint8_t*  CalRaw () const { return blk ? blk + 24 : nullptr; }
+
+}; // class BMP280LogReader
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_LOG_HPP_ */
@@ -0,0 +1,417 @@
+/*
+ * bmp280_metrics.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Per-device counters and latency histograms, and their
+ *    Prometheus text-format export.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <cstdio>                // snprintf()
+#include <stdexcept>             // runtime_error
+
+#include "bmp280_metrics.hpp"    // BMP280Metrics, BMP280Histogram
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+// BMP280Histogram
+// -----------------------------------------------------------------
+
+/*
+ * BMP280Histogram::BMP280Histogram()
+ *
+ * Description:
+ *   Constructor. An empty histogram.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+BMP280Histogram::BMP280Histogram()
+{
+    this->clear();
+}
+
+/*
+ * int BMP280Histogram::Bucket(int64_t ns)
+ *
+ * Description:
+ *   The bucket an observation of ns nanoseconds falls in: the
+ *   smallest k with ns <= Bound(k), or BMP280_HIST_BUCKETS.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+int BMP280Histogram::Bucket(int64_t ns)
+{
+    if (ns <= BMP280_HIST_BASE_NS)
+        return 0;
+
+    uint64_t v = (uint64_t)(ns - 1) / BMP280_HIST_BASE_NS;
+    int      k = 0;
+
+    while (v != 0 && k < BMP280_HIST_BUCKETS)
+    {
+        v >>= 1;
+        k++;
+    }
+
+    return k;
+}
+
+/*
+ * int64_t BMP280Histogram::Bound(int k)
+ *
+ * Description:
+ *   Upper bound of bucket k, nanoseconds.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+int64_t BMP280Histogram::Bound(int k)
+{
+    return (int64_t)BMP280_HIST_BASE_NS << k;
+}
+
+/*
+ * void BMP280Histogram::Record(int64_t ns)
+ *
+ * Description:
+ *   Adds one observation.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+void BMP280Histogram::Record(int64_t ns)
+{
+    if (ns < 0)
+        ns = 0;
+
+    bucket[Bucket(ns)].fetch_add(1, memory_order_relaxed);
+    sumns.fetch_add((uint64_t)ns, memory_order_relaxed);
+}
+
+/*
+ * uint64_t BMP280Histogram::Count() const
+ *
+ * Description:
+ *   The number of observations, summed over the buckets.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+uint64_t BMP280Histogram::Count() const
+{
+    uint64_t n = 0;
+
+    for (int k = 0; k <= BMP280_HIST_BUCKETS; k++)
+        n += bucket[k].load(memory_order_relaxed);
+
+    return n;
+}
+
+/*
+ * void BMP280Histogram::clear()
+ *
+ * Description:
+ *   Discards all observations.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+void BMP280Histogram::clear()
+{
+    for (int k = 0; k <= BMP280_HIST_BUCKETS; k++)
+        bucket[k].store(0, memory_order_relaxed);
+    sumns.store(0, memory_order_relaxed);
+}
+
+
+// BMP280Metrics
+// -----------------------------------------------------------------
+
+/*
+ * BMP280Metrics::BMP280Metrics()
+ *
+ * Description:
+ *   Constructor. All counters zero.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+BMP280Metrics::BMP280Metrics()
+{
+    this->clear();
+}
+
+/*
+ * void BMP280Metrics::Record(BMP280Op op, int64_t ns, int count)
+ *
+ * Description:
+ *   Records one completed operation. Read and Write transfers of
+ *   BMP280_METRICS_STALL_NS or longer also count as stalls.
+ *
+ * Parameters:
+ *   op    - the operation
+ *   ns    - how long it took, nanoseconds
+ *   count - optional. Bytes it moved on the bus. Default 0.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+void BMP280Metrics::Record(BMP280Op op, int64_t ns, int count)
+{
+    hist[(int)op].Record(ns);
+
+    if (count > 0)
+        bytes[(int)op].fetch_add((uint64_t)count, memory_order_relaxed);
+
+    if ((op == BMP280Op::Read || op == BMP280Op::Write) && ns >= BMP280_METRICS_STALL_NS)
+        stalls.fetch_add(1, memory_order_relaxed);
+}
+
+/*
+ * void BMP280Metrics::clear()
+ *
+ * Description:
+ *   Zeroes every counter and histogram.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+void BMP280Metrics::clear()
+{
+    for (int i = 0; i < BMP280_OPS; i++)
+    {
+        hist[i].clear();
+        errors[i].store(0, memory_order_relaxed);
+        bytes[i].store(0, memory_order_relaxed);
+    }
+    stalls.store(0, memory_order_relaxed);
+    polls.store(0, memory_order_relaxed);
+}
+
+/*
+ * const char* BMP280Metrics::Name(BMP280Op op)
+ *
+ * Description:
+ *   The op label value used in the export.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+const char* BMP280Metrics::Name(BMP280Op op)
+{
+    static const char* names[BMP280_OPS] =
+        { "read", "write", "force", "reset", "comp", "comp_batch", "wait" };
+
+    return names[(int)op];
+}
+
+/*
+ * Appends "{labels,extra}", leaving out whichever is empty, or
+ * nothing if both are.
+ */
+static void Labels(string& out, const string& labels, const string& extra)
+{
+    if (labels.empty() && extra.empty())
+        return;
+
+    out += '{';
+    if (!labels.empty())
+    {
+        out += labels;
+        if (!extra.empty())
+            out += ',';
+    }
+    out += extra;
+    out += '}';
+}
+
+static void Sample(string& out, const char* name, const string& labels,
+                   const string& extra, const char* value)
+{
+    out += name;
+    Labels(out, labels, extra);
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+static void Sample(string& out, const char* name, const string& labels,
+                   const string& extra, uint64_t value)
+{
+    char num[24];
+    snprintf(num, sizeof(num), "%llu", (unsigned long long)value);
+    Sample(out, name, labels, extra, num);
+}
+
+static void Family(string& out, const char* name, const char* type, const char* help)
+{
+    out += "# HELP ";  out += name;  out += ' ';  out += help;  out += '\n';
+    out += "# TYPE ";  out += name;  out += ' ';  out += type;  out += '\n';
+}
+
+/*
+ * string BMP280Metrics::Prometheus(
+ *         const vector<const BMP280Metrics*>& devs,
+ *         const vector<string>& labels)
+ *
+ * Description:
+ *   Renders several devices' metrics as one Prometheus text-format
+ *   (version 0.0.4) exposition, each metric family declared once.
+ *
+ *   Families:
+ *     bmp280_op_duration_seconds     histogram, by op
+ *     bmp280_op_errors_total         counter, by op
+ *     bmp280_bus_bytes_total         counter, op read and write
+ *     bmp280_bus_stalls_total        counter
+ *     bmp280_conversion_polls_total  counter
+ *
+ * Parameters:
+ *   devs   - the devices' metrics
+ *   labels - for each device, the label pairs that identify it,
+ *            already formatted: e.g.  bus="1",addr="0x76"
+ *
+ * Returns:
+ *   Returns the exposition text.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if devs and labels differ in size.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+string BMP280Metrics::Prometheus(const vector<const BMP280Metrics*>& devs,
+                                 const vector<string>& labels)
+{
+    if (devs.size() != labels.size())
+    {
+        runtime_error re {"BMP280Metrics::Prometheus(): One label set per device."};
+        throw re;
+    }
+
+    string out;
+    char   num[32];
+
+    Family(out, "bmp280_op_duration_seconds", "histogram",
+           "Latency of driver operations.");
+    for (size_t d = 0; d < devs.size(); d++)
+    {
+        for (int i = 0; i < BMP280_OPS; i++)
+        {
+            const BMP280Histogram& h = devs[d]->hist[i];
+            string   op  = string("op=\"") + Name((BMP280Op)i) + "\"";
+            uint64_t cum = 0;
+
+            for (int k = 0; k < BMP280_HIST_BUCKETS; k++)
+            {
+                cum += h.bucket[k].load(memory_order_relaxed);
+                snprintf(num, sizeof(num), "%.10g", BMP280Histogram::Bound(k) * 1e-9);
+                Sample(out, "bmp280_op_duration_seconds_bucket", labels[d],
+                       op + ",le=\"" + num + "\"", cum);
+            }
+            cum += h.bucket[BMP280_HIST_BUCKETS].load(memory_order_relaxed);
+            Sample(out, "bmp280_op_duration_seconds_bucket", labels[d], op + ",le=\"+Inf\"", cum);
+
+            snprintf(num, sizeof(num), "%.9g", h.sumns.load(memory_order_relaxed) * 1e-9);
+            Sample(out, "bmp280_op_duration_seconds_sum", labels[d], op, num);
+            Sample(out, "bmp280_op_duration_seconds_count", labels[d], op, cum);
+        }
+    }
+
+    Family(out, "bmp280_op_errors_total", "counter",
+           "Driver operations that ended in an exception.");
+    for (size_t d = 0; d < devs.size(); d++)
+        for (int i = 0; i < BMP280_OPS; i++)
+            Sample(out, "bmp280_op_errors_total", labels[d],
+                   string("op=\"") + Name((BMP280Op)i) + "\"", devs[d]->Errors((BMP280Op)i));
+
+    Family(out, "bmp280_bus_bytes_total", "counter",
+           "Bytes moved on the bus, register addresses included.");
+    for (size_t d = 0; d < devs.size(); d++)
+    {
+        Sample(out, "bmp280_bus_bytes_total", labels[d], "op=\"read\"",  devs[d]->Bytes(BMP280Op::Read));
+        Sample(out, "bmp280_bus_bytes_total", labels[d], "op=\"write\"", devs[d]->Bytes(BMP280Op::Write));
+    }
+
+    Family(out, "bmp280_bus_stalls_total", "counter",
+           "Bus transfers slower than the stall threshold.");
+    for (size_t d = 0; d < devs.size(); d++)
+        Sample(out, "bmp280_bus_stalls_total", labels[d], "", devs[d]->Stalls());
+
+    Family(out, "bmp280_conversion_polls_total", "counter",
+           "Forced reads that found the conversion still running.");
+    for (size_t d = 0; d < devs.size(); d++)
+        Sample(out, "bmp280_conversion_polls_total", labels[d], "", devs[d]->Polls());
+
+    return out;
+}
+
+/*
+ * string BMP280Metrics::Prometheus(const string& labels) const
+ *
+ * Description:
+ *   Renders this device's metrics as a Prometheus text exposition.
+ *
+ * Parameters:
+ *   labels - optional. Label pairs that identify the device, already
+ *            formatted. Default none.
+ *
+ * Returns:
+ *   Returns the exposition text.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+string BMP280Metrics::Prometheus(const string& labels) const
+{
+    return Prometheus(vector<const BMP280Metrics*>{ this }, vector<string>{ labels });
+}
+
+} // namespace bosch_bmp280
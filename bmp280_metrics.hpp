@@ -0,0 +1,219 @@
+/*
+ * bmp280_metrics.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Per-device counters and latency histograms for the driver's
+ *    bus transactions, conversion waits and compensation, with a
+ *    Prometheus text-format export.
+ *
+ *  Notes:
+ *    1. Instrumentation is compiled in only when BMP280_METRICS is
+ *       defined non-zero (e.g. -DBMP280_METRICS=1). Otherwise the
+ *       BMP280_METRIC_* macros expand to nothing and BMP280 carries
+ *       no metrics member, so the driver is exactly as it was.
+ *    2. Every counter is a relaxed atomic, so recording never takes a
+ *       lock and export may run from any thread. An export taken
+ *       while readings are in flight may be one observation behind in
+ *       some series; the histogram count is always derived from its
+ *       own buckets, so each histogram is self-consistent.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_METRICS_HPP_
+#define BMP280_METRICS_HPP_
+
+#include <atomic>              // atomic
+#include <stdint.h>            // uint8_t, int64_t, uint64_t
+#include <string>              // string
+#include <vector>              // vector
+
+#include "bmp280_data.hpp"     // MonotonicNs()
+
+namespace bosch_bmp280
+{
+
+#ifndef BMP280_METRICS
+  #define BMP280_METRICS  0
+#endif
+
+// A bus transfer that takes at least this long (nanoseconds) is
+// counted as a stall.
+#ifndef BMP280_METRICS_STALL_NS
+  #define BMP280_METRICS_STALL_NS  2000000
+#endif
+
+// Histogram buckets: upper bounds of BASE_NS * 2^k nanoseconds,
+// k = 0 .. BUCKETS-1 (256 ns to about 2.1 s), then +Inf.
+#define BMP280_HIST_BASE_NS   256
+#define BMP280_HIST_BUCKETS   24
+
+// Instrumented operations.
+enum class BMP280Op : uint8_t
+{
+    Read = 0,       // GetRegs() transfer
+    Write,          // SetRegs() transfer
+    Force,          // Force(), including any shadow resync
+    Reset,          // SendReset()
+    Comp,           // one reading compensated
+    CompBatch,      // one batch compensated
+    Wait,           // Force() to a forced reading ready, MeasureForced()
+    Count_
+};
+
+#define BMP280_OPS  ((int)BMP280Op::Count_)
+
+
+/*
+ * struct BMP280Histogram
+ *
+ * Description:
+ *   A log-bucketed latency histogram. bucket[k] counts observations
+ *   no longer than Bound(k); bucket[BMP280_HIST_BUCKETS] counts the
+ *   rest. Buckets are not cumulative; the export makes them so.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+struct BMP280Histogram
+{
+    std::atomic<uint64_t>  bucket[BMP280_HIST_BUCKETS + 1];
+    std::atomic<uint64_t>  sumns;
+
+    BMP280Histogram ();
+
+    void      Record ( int64_t ns );
+    uint64_t  Count  () const;
+    void      clear  ();
+
+    static int      Bucket ( int64_t ns );
+    static int64_t  Bound  ( int k );
+};
+
+
+/*
+ * class BMP280Metrics
+ *
+ * Description:
+ *   Metrics for one device: for each BMP280Op a latency histogram,
+ *   an error count and a byte count, plus bus stalls (transfers of
+ *   BMP280_METRICS_STALL_NS or more) and conversion polls (forced
+ *   reads that found the measurement still running).
+ *
+ *   BMP280 records into its own instance when BMP280_METRICS is set,
+ *   and hands it out through BMP280::Metrics(). An instance may also
+ *   be used directly, for any code that wants the same export.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+class BMP280Metrics
+{
+  protected:
+    BMP280Histogram        hist[BMP280_OPS];
+    std::atomic<uint64_t>  errors[BMP280_OPS];
+    std::atomic<uint64_t>  bytes[BMP280_OPS];
+    std::atomic<uint64_t>  stalls;
+    std::atomic<uint64_t>  polls;
+
+  public:
+
+    BMP280Metrics ();
+
+    void  Record ( BMP280Op op, int64_t ns, int count=0 );
+    void  Error  ( BMP280Op op ) { errors[(int)op].fetch_add(1, std::memory_order_relaxed); }
+    void  Poll   ()              { polls.fetch_add(1, std::memory_order_relaxed); }
+    void  clear  ();
+
+    const BMP280Histogram&  Histogram ( BMP280Op op ) const { return hist[(int)op]; }
+
+    uint64_t  Count  ( BMP280Op op ) const { return hist[(int)op].Count(); }
+    uint64_t  Errors ( BMP280Op op ) const { return errors[(int)op].load(std::memory_order_relaxed); }
+    uint64_t  Bytes  ( BMP280Op op ) const { return bytes[(int)op].load(std::memory_order_relaxed); }
+    uint64_t  Stalls () const { return stalls.load(std::memory_order_relaxed); }
+    uint64_t  Polls  () const { return polls.load(std::memory_order_relaxed); }
+
+    std::string  Prometheus ( const std::string& labels="" ) const;
+
+    static std::string  Prometheus ( const std::vector<const BMP280Metrics*>& devs,
+                                     const std::vector<std::string>& labels );
+    static const char*  Name       ( BMP280Op op );
+
+}; // class BMP280Metrics
+
+
+/*
+ * class BMP280MetricScope
+ *
+ * Description:
+ *   Times one operation. Done() records its latency and byte count;
+ *   a scope that ends without Done(), because an exception went
+ *   through it, records an error instead.
+ *
+ *   Use it through the BMP280_METRIC_SCOPE/BMP280_METRIC_DONE macros,
+ *   which vanish when BMP280_METRICS is off.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_metrics.hpp
+ */
+class BMP280MetricScope
+{
+  protected:
+    BMP280Metrics&  metrics;
+    BMP280Op        op;
+    int             count;
+    int64_t         start;
+    bool            done;
+
+  public:
+
+    BMP280MetricScope ( BMP280Metrics& m, BMP280Op o, int bytes=0 )
+        : metrics(m), op(o), count(bytes), start(MonotonicNs()), done(false)
+    { }
+
+    ~BMP280MetricScope ()
+    {
+        if (!done) metrics.Error(op);
+    }
+
+    void  Done ()
+    {
+        metrics.Record(op, MonotonicNs() - start, count);
+        done = true;
+    }
+
+}; // class BMP280MetricScope
+
+
+#if BMP280_METRICS
+  #define BMP280_METRIC_SCOPE(m, op, bytes)  BMP280MetricScope bmp280_metric_scope_((m), (op), (bytes))
+  #define BMP280_METRIC_DONE()               bmp280_metric_scope_.Done()
+  #define BMP280_METRIC_POLL(m)              (m).Poll()
+#else
+  #define BMP280_METRIC_SCOPE(m, op, bytes)
+  #define BMP280_METRIC_DONE()
+  #define BMP280_METRIC_POLL(m)
+#endif
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_METRICS_HPP_ */
@@ -0,0 +1,582 @@
+/*
+ * bmp280_pyramid.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Multi-resolution summaries of BMP280 readings.
+ *
+ *  Notes:
+ *    1. Whenever a reading is pushed, every level's open bucket is
+ *       for the window that contains the previous reading. Level zero
+ *       holds the readings of that window, and each level above holds
+ *       only the completed buckets below it in its own window, so the
+ *       open buckets never overlap. The still-open part of a level's
+ *       window is its open bucket merged with every open bucket below.
+ *    2. Moment sums are of deviations from the first reading ever
+ *       pushed, as in TP32DataQueue and TP32Series.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <stdexcept>            // runtime_error
+
+#include "bmp280_pyramid.hpp"   // TP32Pyramid
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+// TP32Pyramid Constructors
+// -----------------------------------------------------------------
+
+/*
+ * TP32Pyramid::TP32Pyramid()
+ *
+ * Description:
+ *   Constructor. Three levels: one-minute buckets for a day, one-hour
+ *   buckets for a month, and one-day buckets for a year.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_pyramid.hpp
+ */
+TP32Pyramid::TP32Pyramid()
+    : TP32Pyramid( { {60, 1440}, {3600, 744}, {86400, 366} } )
+{ }
+
+/*
+ * TP32Pyramid::TP32Pyramid(const vector<TP32PyramidLevel>& spec)
+ *
+ * Description:
+ *   Constructor. Storage for every level is allocated here.
+ *
+ * Parameters:
+ *   spec - the levels, finest first
+ *
+ * Exceptions:
+ *   Throws a runtime_error if spec is empty, if a width or a keep is
+ *   zero, or if a width is not a whole multiple of the one before it.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_pyramid.hpp
+ */
+TP32Pyramid::TP32Pyramid(const vector<TP32PyramidLevel>& spec)
+{
+    if (spec.empty())
+    {
+        runtime_error re {"TP32Pyramid::TP32Pyramid(): No levels given."};
+        throw re;
+    }
+
+    for (size_t i = 0; i < spec.size(); i++)
+    {
+        if (spec[i].width <= 0 || spec[i].keep == 0)
+        {
+            runtime_error re {"TP32Pyramid::TP32Pyramid(): Width and keep must be non-zero."};
+            throw re;
+        }
+        if (i > 0 && spec[i].width % spec[i-1].width != 0)
+        {
+            runtime_error re {"TP32Pyramid::TP32Pyramid(): Widths must nest."};
+            throw re;
+        }
+    }
+
+    levels.reserve(spec.size());
+    for (size_t i = 0; i < spec.size(); i++)
+        levels.push_back(Level(spec[i].width, spec[i].keep));
+
+    hasref = false;
+    tref   = 0;
+    pref   = 0;
+}
+
+
+// TP32Pyramid Protected
+// -----------------------------------------------------------------
+
+/*
+ * void TP32Pyramid::Merge(const Bucket& b, Bucket& into)
+ *
+ * Description:
+ *   Adds bucket b, which must be later than anything in into, to
+ *   into. into.start is left alone.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_pyramid.hpp
+ */
+void TP32Pyramid::Merge(const Bucket& b, Bucket& into)
+{
+    if (b.agg.count == 0)
+        return;
+
+    if (into.agg.count == 0) into.tfirst = b.tfirst;
+    into.tlast = b.tlast;
+    into.agg.merge(b.agg);
+}
+
+/*
+ * time_t TP32Pyramid::Window(size_t level, time_t t) const
+ *
+ * Description:
+ *   Returns the start of the level's window that contains t.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_pyramid.hpp
+ */
+time_t TP32Pyramid::Window(size_t level, time_t t) const
+{
+    time_t w = levels[level].width;
+    time_t r = t % w;
+
+    return (r < 0) ? t - r - w : t - r;
+}
+
+/*
+ * void TP32Pyramid::Close(size_t level)
+ *
+ * Description:
+ *   Completes the open bucket of a level: stores it, dropping the
+ *   oldest completed bucket if the level is full, and merges it into
+ *   the level above.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_pyramid.hpp
+ */
+void TP32Pyramid::Close(size_t level)
+{
+    Level& lv = levels[level];
+
+    if (!lv.isopen)
+        return;
+
+    if (lv.done.full())
+        lv.done.pop_front();
+    lv.done.push_back(lv.open);
+    lv.isopen = false;
+
+    if (level + 1 < levels.size())
+        this->MergeUp(level + 1, lv.open);
+}
+
+/*
+ * void TP32Pyramid::MergeUp(size_t level, const Bucket& b)
+ *
+ * Description:
+ *   Merges a completed bucket from the level below into the open
+ *   bucket of a level, opening it if need be. The open bucket is
+ *   always for b's window (see Notes).
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_pyramid.hpp
+ */
+void TP32Pyramid::MergeUp(size_t level, const Bucket& b)
+{
+    Level& lv = levels[level];
+
+    if (!lv.isopen)
+    {
+        lv.open   = Bucket(this->Window(level, b.start));
+        lv.isopen = true;
+    }
+
+    Merge(b, lv.open);
+}
+
+/*
+ * void TP32Pyramid::Partial(size_t level, Bucket& b) const
+ *
+ * Description:
+ *   Builds the still-open bucket of a level, from its open bucket
+ *   and those of every level below. b.agg.count is zero if there is
+ *   none.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_pyramid.hpp
+ */
+void TP32Pyramid::Partial(size_t level, Bucket& b) const
+{
+    b = Bucket();
+
+    // Highest level first, so tfirst..tlast come out in order.
+    for (size_t i = level + 1; i-- > 0; )
+    {
+        if (!levels[i].isopen)
+            continue;
+
+        if (b.agg.count == 0)
+            b.start = this->Window(level, levels[i].open.start);
+        Merge(levels[i].open, b);
+    }
+}
+
+/*
+ * size_t TP32Pyramid::First(size_t level, time_t from) const
+ *
+ * Description:
+ *   Binary search. Returns the index of the first completed bucket
+ *   of a level whose window ends after from.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_pyramid.hpp
+ */
+size_t TP32Pyramid::First(size_t level, time_t from) const
+{
+    const Level& lv = levels[level];
+    size_t lo = 0;
+    size_t hi = lv.done.size();
+
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo)/2;
+        if (lv.done[mid].start + lv.width <= from)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/*
+ * void TP32Pyramid::ToSummary(const Bucket& b,
+ *                             TP32Summary& temp, TP32Summary& press) const
+ *
+ * Description:
+ *   Converts a bucket into temperature and pressure summaries.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_pyramid.hpp
+ */
+void TP32Pyramid::ToSummary(const Bucket& b, TP32Summary& temp, TP32Summary& press) const
+{
+    b.agg.summary(tref, pref, b.tfirst, b.tlast, temp, press);
+}
+
+
+// TP32Pyramid Public
+// -----------------------------------------------------------------
+
+/*
+ * void TP32Pyramid::Push(const TP32Data& reading)
+ *
+ * Description:
+ *   Adds a reading. If it is in a later window than the one being
+ *   filled, the open buckets it has left behind are completed first,
+ *   from the bottom level up.
+ *
+ * Parameters:
+ *   reading - the reading to add
+ *
+ * Exceptions:
+ *   Throws a runtime_error if the reading is older than the window
+ *   being filled.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_pyramid.hpp
+ */
+void TP32Pyramid::Push(const TP32Data& reading)
+{
+    time_t t = reading.timestamp;
+
+    if (levels[0].isopen && t < levels[0].open.start)
+    {
+        runtime_error re {"TP32Pyramid::Push(): Reading is out of order."};
+        throw re;
+    }
+
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        if (levels[i].isopen && levels[i].open.start != this->Window(i, t))
+            this->Close(i);
+    }
+
+    if (!hasref)
+    {
+        tref   = reading.temperature;
+        pref   = reading.pressure;
+        hasref = true;
+    }
+
+    Level& lv = levels[0];
+
+    if (!lv.isopen)
+    {
+        lv.open   = Bucket(this->Window(0, t));
+        lv.isopen = true;
+    }
+
+    Bucket& b = lv.open;
+
+    if (b.agg.count == 0) b.tfirst = t;
+    b.tlast = t;
+    b.agg.add(reading.temperature, reading.pressure, tref, pref);
+}
+
+/*
+ * void TP32Pyramid::Flush()
+ *
+ * Description:
+ *   Completes every open bucket, from the bottom level up, as if a
+ *   reading had arrived for a later window at every level. Use it
+ *   before shutting down, not between readings: a window flushed
+ *   early is stored as two buckets if more readings arrive for it.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_pyramid.hpp
+ */
+void TP32Pyramid::Flush()
+{
+    for (size_t i = 0; i < levels.size(); i++)
+        this->Close(i);
+}
+
+/*
+ * void TP32Pyramid::clear()
+ *
+ * Description:
+ *   Discards all buckets, completed and open.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_pyramid.hpp
+ */
+void TP32Pyramid::clear()
+{
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        levels[i].done.clear();
+        levels[i].isopen = false;
+    }
+    hasref = false;
+}
+
+/*
+ * time_t TP32Pyramid::Width(size_t level) const
+ *
+ * Description:
+ *   Returns the bucket width of a level, in seconds.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if level is out of range.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_pyramid.hpp
+ */
+time_t TP32Pyramid::Width(size_t level) const
+{
+    if (level >= levels.size())
+    {
+        runtime_error re {"TP32Pyramid::Width(): No such level."};
+        throw re;
+    }
+
+    return levels[level].width;
+}
+
+/*
+ * size_t TP32Pyramid::Buckets(size_t level) const
+ *
+ * Description:
+ *   Returns the number of completed buckets held at a level.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if level is out of range.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_pyramid.hpp
+ */
+size_t TP32Pyramid::Buckets(size_t level) const
+{
+    if (level >= levels.size())
+    {
+        runtime_error re {"TP32Pyramid::Buckets(): No such level."};
+        throw re;
+    }
+
+    return levels[level].done.size();
+}
+
+/*
+ * size_t TP32Pyramid::Query(size_t level, time_t from, time_t to,
+ *                           vector<TP32Summary>& temp, vector<TP32Summary>& press,
+ *                           bool partial) const
+ *
+ * Description:
+ *   Appends a temperature and a pressure summary for each bucket of a
+ *   level whose window overlaps [from, to], oldest first. This is the
+ *   call for plotting: one point per minute, hour or day.
+ *
+ *   Windows are not cut at from and to; a bucket that overlaps the
+ *   range is reported whole.
+ *
+ * Parameters:
+ *   level   - the level to read
+ *   from    - start of the range, inclusive
+ *   to      - end of the range, inclusive
+ *   temp    - receives the temperature summaries
+ *   press   - receives the pressure summaries
+ *   partial - optional. If true, the window still being filled is
+ *             reported too, from what it holds so far. The default
+ *             is true.
+ *
+ * Returns:
+ *   Returns the number of summaries appended to each vector.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if level is out of range.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_pyramid.hpp
+ */
+size_t TP32Pyramid::Query(size_t level, time_t from, time_t to,
+                          vector<TP32Summary>& temp, vector<TP32Summary>& press,
+                          bool partial) const
+{
+    if (level >= levels.size())
+    {
+        runtime_error re {"TP32Pyramid::Query(): No such level."};
+        throw re;
+    }
+
+    const Level& lv = levels[level];
+    size_t n = 0;
+    TP32Summary ts, ps;
+
+    for (size_t i = this->First(level, from); i < lv.done.size() && lv.done[i].start <= to; i++)
+    {
+        this->ToSummary(lv.done[i], ts, ps);
+        temp.push_back(ts);
+        press.push_back(ps);
+        n++;
+    }
+
+    if (partial)
+    {
+        Bucket b;
+        this->Partial(level, b);
+        if (b.agg.count > 0 && b.start <= to && b.start + lv.width > from)
+        {
+            this->ToSummary(b, ts, ps);
+            temp.push_back(ts);
+            press.push_back(ps);
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/*
+ * int TP32Pyramid::Summarize(size_t level, time_t from, time_t to,
+ *                            TP32Summary& temp, TP32Summary& press,
+ *                            bool partial) const
+ *
+ * Description:
+ *   Summarizes, as one, every bucket of a level whose window overlaps
+ *   [from, to]. Pick the coarsest level whose width still suits the
+ *   range: a month at the hour level is about 720 buckets.
+ *
+ *   As with Query(), windows are not cut at from and to.
+ *
+ * Parameters:
+ *   level   - the level to read
+ *   from    - start of the range, inclusive
+ *   to      - end of the range, inclusive
+ *   temp    - receives the temperature summary
+ *   press   - receives the pressure summary
+ *   partial - optional. If true, the window still being filled is
+ *             included. The default is true.
+ *
+ * Returns:
+ *   Returns the number of readings summarized. If it is zero, the
+ *   summaries hold zeroes.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if level is out of range.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_pyramid.hpp
+ */
+int TP32Pyramid::Summarize(size_t level, time_t from, time_t to,
+                           TP32Summary& temp, TP32Summary& press,
+                           bool partial) const
+{
+    if (level >= levels.size())
+    {
+        runtime_error re {"TP32Pyramid::Summarize(): No such level."};
+        throw re;
+    }
+
+    const Level& lv = levels[level];
+    Bucket tot;
+
+    for (size_t i = this->First(level, from); i < lv.done.size() && lv.done[i].start <= to; i++)
+        Merge(lv.done[i], tot);
+
+    if (partial)
+    {
+        Bucket b;
+        this->Partial(level, b);
+        if (b.agg.count > 0 && b.start <= to && b.start + lv.width > from)
+            Merge(b, tot);
+    }
+
+    this->ToSummary(tot, temp, press);
+
+    return tot.agg.count;
+}
+
+} // namespace bosch_bmp280
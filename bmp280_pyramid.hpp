@@ -0,0 +1,153 @@
+/*
+ * bmp280_pyramid.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Multi-resolution summaries of BMP280 readings: minute, hour and
+ *    day buckets (or whatever widths are asked for), each level built
+ *    from the one below it.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_PYRAMID_HPP_
+#define BMP280_PYRAMID_HPP_
+
+#include <cstddef>           // size_t
+#include <ctime>             // time_t
+#include <stdint.h>          // int32_t, uint32_t
+#include <vector>            // vector
+
+#include "bmp280_data.hpp"   // TP32Data, TP32Summary, TP32Aggregate
+#include "bmp280_ring.hpp"   // RingBuffer
+
+namespace bosch_bmp280
+{
+
+/*
+ * struct TP32PyramidLevel
+ *
+ * Description:
+ *   One level of a TP32Pyramid.
+ *
+ *   width - bucket width, in seconds. Must be a whole multiple of
+ *           the width of the level below.
+ *   keep  - number of completed buckets to hold. Older buckets are
+ *           dropped.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_pyramid.hpp
+ */
+struct TP32PyramidLevel
+{
+    time_t  width;
+    size_t  keep;
+};
+
+
+/*
+ * class TP32Pyramid
+ *
+ * Description:
+ *   A cascading aggregator. Readings go into the open bucket of level
+ *   zero. When a reading arrives for a later window, the open bucket
+ *   is completed, stored, and merged into the open bucket of the
+ *   level above, and so on up: a level only ever sees completed
+ *   buckets from the level below, never raw readings.
+ *
+ *   Bucket windows are aligned to whole multiples of their width, in
+ *   time_t seconds, so minute, hour and day buckets line up with the
+ *   clock (days with UTC midnight).
+ *
+ *   Buckets keep high, low and integer moment sums rather than
+ *   averages, so merging them is exact and a day's average is the
+ *   same one a TP32DataQueue of that whole day would give. A query
+ *   over a month of hour buckets touches seven hundred buckets and no
+ *   readings.
+ *
+ *   Feed it the same readings as a TP32DataQueue that holds the last
+ *   few minutes, and the queue no longer has to hold anything longer.
+ *
+ *   Readings must be pushed in time stamp order.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_pyramid.hpp
+ */
+class TP32Pyramid
+{
+  protected:
+    struct Bucket
+    {
+        time_t         start;            // window start
+        time_t         tfirst, tlast;    // first and last reading
+        TP32Aggregate  agg;
+
+        Bucket ( time_t s=0 ) : start(s), tfirst(0), tlast(0) { }
+    };
+
+    struct Level
+    {
+        time_t              width;
+        RingBuffer<Bucket>  done;
+        Bucket              open;
+        bool                isopen;
+
+        Level ( time_t w, size_t keep ) : width(w), done(keep), open(), isopen(false) { }
+    };
+
+    std::vector<Level>  levels;
+
+    bool      hasref;
+    int32_t   tref;
+    uint32_t  pref;
+
+    time_t  Window  ( size_t level, time_t t ) const;
+    void    Close   ( size_t level );
+    void    MergeUp ( size_t level, const Bucket& b );
+    void    Partial ( size_t level, Bucket& b ) const;
+    size_t  First   ( size_t level, time_t from ) const;
+
+    void    ToSummary ( const Bucket& b, TP32Summary& temp, TP32Summary& press ) const;
+
+    static void    Merge ( const Bucket& b, Bucket& into );
+
+  public:
+
+    TP32Pyramid ();
+    TP32Pyramid ( const std::vector<TP32PyramidLevel>& spec );
+
+    void    Push  ( const TP32Data& reading );
+    void    Flush ();
+    void    clear ();
+
+    size_t  Levels  () const { return levels.size(); }
+    time_t  Width   ( size_t level ) const;
+    size_t  Buckets ( size_t level ) const;
+
+    size_t  Query     ( size_t level, time_t from, time_t to,
+                        std::vector<TP32Summary>& temp, std::vector<TP32Summary>& press,
+                        bool partial=true ) const;
+    int     Summarize ( size_t level, time_t from, time_t to,
+                        TP32Summary& temp, TP32Summary& press,
+                        bool partial=true ) const;
+
+}; // class TP32Pyramid
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_PYRAMID_HPP_ */
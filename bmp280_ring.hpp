@@ -0,0 +1,145 @@
+/*
+ * bmp280_ring.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Fixed-capacity ring buffer used as sample storage by the
+ *    BMP280 data structures.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_RING_HPP_
+#define BMP280_RING_HPP_
+
+#include <cstddef>           // size_t
+#include <stdexcept>         // runtime_error
+#include <vector>            // vector
+
+namespace bosch_bmp280
+{
+
+/*
+ * template<typename T> class RingBuffer
+ *
+ * Description:
+ *   A double-ended queue with a fixed capacity, stored in one
+ *   contiguous block of memory.
+ *
+ *   All storage is allocated by the constructor. After that, no
+ *   operation allocates or frees memory, so a queue that runs at
+ *   capacity for weeks does not fragment the heap.
+ *
+ *   Elements are held in two contiguous spans at most: from the
+ *   front of the queue to the end of storage, and from the start
+ *   of storage to the back of the queue.
+ *
+ *   push_back() on a full buffer throws a runtime_error. The owner
+ *   is expected to pop_front() first.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_ring.hpp
+ */
+template<typename T>
+class RingBuffer
+{
+  protected:
+    std::vector<T> buf;
+    size_t rcap;
+    size_t head;             // storage index of the front element
+    size_t count;            // number of elements
+
+    // Storage index of the i-th element from the front.
+    size_t slot ( size_t i ) const
+    {
+        size_t j = head + i;
+        return (j >= rcap) ? j - rcap : j;
+    }
+
+  public:
+
+    RingBuffer ( size_t capacity ) : buf(capacity), rcap(capacity), head(0), count(0)
+    { }
+
+    size_t  capacity () const { return rcap;           }
+    size_t  size     () const { return count;          }
+    bool    empty    () const { return count == 0;     }
+    bool    full     () const { return count >= rcap;  }
+
+    T&        front ()       { return buf[head];             }
+    const T&  front () const { return buf[head];             }
+    T&        back  ()       { return buf[slot(count - 1)];  }
+    const T&  back  () const { return buf[slot(count - 1)];  }
+
+    T&        operator[] ( size_t i )       { return buf[slot(i)]; }
+    const T&  operator[] ( size_t i ) const { return buf[slot(i)]; }
+
+    // Storage index of the i-th element. Buffers of the same capacity
+    // that are pushed and popped together share positions.
+    size_t  position ( size_t i ) const { return slot(i); }
+
+    // First contiguous span: from the front toward the end of storage.
+    const T* span1 ( size_t& len ) const
+    {
+        len = (head + count > rcap) ? rcap - head : count;
+        return buf.data() + head;
+    }
+
+    // Second contiguous span: from the start of storage to the back.
+    // len is zero if the elements do not wrap.
+    const T* span2 ( size_t& len ) const
+    {
+        len = (head + count > rcap) ? head + count - rcap : 0;
+        return buf.data();
+    }
+
+    void push_back ( const T& item )
+    {
+        if (count >= rcap)
+        {
+            std::runtime_error re {"RingBuffer::push_back(): The buffer is full."};
+            throw re;
+        }
+
+        buf[slot(count)] = item;
+        count++;
+    }
+
+    void pop_front ()
+    {
+        if (count > 0)
+        {
+            head = slot(1);
+            count--;
+        }
+    }
+
+    void pop_back ()
+    {
+        if (count > 0)
+            count--;
+    }
+
+    void clear ()
+    {
+        head  = 0;
+        count = 0;
+    }
+
+}; // class RingBuffer
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_RING_HPP_ */
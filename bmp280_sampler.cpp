@@ -0,0 +1,477 @@
+/*
+ * bmp280_sampler.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Normal-mode sampling, phase-locked to the device's conversion
+ *    cadence.
+ *
+ *  Notes:
+ *    1. Edges are timed from the start of each status read, midway
+ *       between the polls either side, so they are good to half a
+ *       poll (or half a bus read, if that is longer). Regular reads
+ *       are aimed half the standby time (at most four polls) after
+ *       the predicted edge, inside the standby window, where status
+ *       and data are unambiguous.
+ *    2. Before the period has been measured, a resync wakes early
+ *       enough to cover the gap between typical and maximum
+ *       conversion time (about 13%) and t_sb tolerance, polling
+ *       coarsely (every half conversion time) until the measuring
+ *       bit is seen, then finely.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <cerrno>                // EINTR
+#include <cmath>                 // llround()
+#include <ctime>                 // clock_nanosleep(), timespec
+#include <stdexcept>             // runtime_error
+
+#include "bmp280_config.hpp"     // BMP280Config
+#include "bmp280_sampler.hpp"    // BMP280NormalSampler
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+/*
+ * Sleeps until MonotonicNs() reaches ns. Returns at once if it
+ * already has.
+ */
+static void SleepUntil(int64_t ns)
+{
+    struct timespec ts;
+    ts.tv_sec  = (time_t)(ns / 1000000000);
+    ts.tv_nsec = (long)(ns % 1000000000);
+
+    while (clock_nanosleep(BMP280_CLOCK, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+        ;
+}
+
+
+// Class Public
+// -----------------------------------------------------------------
+
+/*
+ * BMP280NormalSampler::BMP280NormalSampler(BMP280& device)
+ *
+ * Description:
+ *   Constructor. Nothing is read until Lock() or Next().
+ *
+ * Parameters:
+ *   device - a BMP280 in normal mode. Not owned; must outlive the
+ *            sampler.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sampler.hpp
+ */
+BMP280NormalSampler::BMP280NormalSampler(BMP280& device)
+    : dev(&device)
+{
+    period  = 1;
+    meas    = 0;
+    guard   = 0;
+    edge    = 0;
+    count   = 0;
+    syncat  = 1;
+    locked  = false;
+    refined = false;
+
+    havelast    = false;
+    havepending = false;
+
+    reads   = 0;
+    samples = 0;
+    dupes   = 0;
+    resyncs = 0;
+}
+
+/*
+ * void BMP280NormalSampler::Lock()
+ *
+ * Description:
+ *   Takes the period from the device configuration, then polls to
+ *   the end of a conversion and locks to it. The reading found there
+ *   is returned by the next Next().
+ *
+ *   Usually costs one or two periods, and (in the worst case) two
+ *   status reads per conversion time within them.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if the device is not in normal mode, or
+ *   finishes no conversion within four periods.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sampler.hpp
+ */
+void BMP280NormalSampler::Lock()
+{
+    uint8_t ctrl, conf;
+    dev->GetConfig(ctrl, conf);
+
+    BMP280Config cfg = BMP280Config::FromRegs(ctrl, conf);
+    if (cfg.mode != Mode::Normal)
+    {
+        runtime_error re {"BMP280NormalSampler::Lock(): Device is not in normal mode."};
+        throw re;
+    }
+
+    cal    = dev->Calibration<Cal32Fixed>();
+    period = (int64_t)cfg.Period() * 1000;
+    meas   = (int64_t)cfg.MeasureTime() * 1000;
+    // Land reads in the standby time, after one edge and before the
+    // next conversion starts to change anything.
+    guard  = (int64_t)BMP280_SAMPLER_POLL * 4000;
+    if (guard > (int64_t)StandbyTime(cfg.tsb) * 500)
+        guard = (int64_t)StandbyTime(cfg.tsb) * 500;
+
+    int64_t  deadline = MonotonicNs() + 4*period;
+    TP32Data raw;
+    bool     late = true;
+    int64_t  t = -1;
+
+    // A conversion that ends between coarse polls gives no edge; wait
+    // for the next one.
+    while (late)
+    {
+        t = this->Edge(deadline, nullptr, raw, late);
+        if (t < 0)
+        {
+            locked = false;
+            runtime_error re {"BMP280NormalSampler::Lock(): No conversion finished."};
+            throw re;
+        }
+    }
+
+    edge    = t;
+    count   = 0;
+    syncat  = 1;
+    locked  = true;
+    refined = false;
+
+    pending     = raw;
+    havepending = true;
+}
+
+/*
+ * TP32Data BMP280NormalSampler::Next()
+ *
+ * Description:
+ *   Waits for the next conversion and returns it, compensated. Each
+ *   conversion is returned at most once.
+ *
+ *   Locks first, if not locked.
+ *
+ * Returns:
+ *   Returns a TP32Data structure containing time stamps, a temperature
+ *   reading (in 1/100 degrees centigrade), and a pressure reading (in
+ *   pascals).
+ *
+ * Exceptions:
+ *   runtime_error, from Lock()
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sampler.hpp
+ */
+TP32Data BMP280NormalSampler::Next()
+{
+    for (;;)
+    {
+        TP32Data raw;
+        bool     got = false;
+
+        if (havepending)
+        {
+            havepending = false;
+            raw = pending;
+            got = true;
+        }
+        else if (!locked)
+        {
+            this->Lock();
+        }
+        else
+        {
+            int64_t due = edge + (count + 1) * period;
+
+            if (count + 1 >= syncat)
+            {
+                this->Resync(due);
+            }
+            else
+            {
+                SleepUntil(due + guard);
+                uint8_t st = this->Fetch(raw);
+
+                if (this->Fresh(raw))
+                {
+                    count++;
+                    got = true;
+                }
+                else if (st & BMP280_STATUS_MEAS)
+                {
+                    // Converting, with the old data: early, or late by
+                    // more than t_sb after a repeated reading. The next
+                    // edge tells which.
+                    syncat = count + 1;
+                }
+                else if (refined)
+                {
+                    // Finished on a measured schedule: a new conversion
+                    // that happens to repeat the last one.
+                    count++;
+                    got = true;
+                }
+                else
+                {
+                    // Nothing says this is not the reading already
+                    // returned. Drop it and find the edge.
+                    dupes++;
+                    syncat = count + 1;
+                }
+            }
+        }
+
+        if (!got)
+            continue;
+
+        last     = raw;
+        havelast = true;
+        samples++;
+
+        return cal.Compensate(raw);
+    }
+}
+
+/*
+ * int BMP280NormalSampler::Next(TP32Data* buf, int count)
+ *
+ * Description:
+ *   Takes the next count conversions, as Next() does.
+ *
+ * Parameters:
+ *   buf   - receives count readings
+ *   count - the number of readings to take
+ *
+ * Returns:
+ *   Returns the number of readings stored in buf.
+ *
+ * Exceptions:
+ *   runtime_error, from Lock()
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sampler.hpp
+ */
+int BMP280NormalSampler::Next(TP32Data* buf, int count)
+{
+    for (int i = 0; i < count; i++)
+        buf[i] = this->Next();
+
+    return count;
+}
+
+
+// Class Protected
+// -----------------------------------------------------------------
+
+/*
+ * uint8_t BMP280NormalSampler::Fetch(TP32Data& raw)
+ *
+ * Description:
+ *   One status and data burst. Returns the status register.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sampler.hpp
+ */
+uint8_t BMP280NormalSampler::Fetch(TP32Data& raw)
+{
+    reads++;
+    return dev->GetUncompStatus(raw);
+}
+
+/*
+ * bool BMP280NormalSampler::Fresh(const TP32Data& raw) const
+ *
+ * Description:
+ *   true if raw differs from the last reading returned.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sampler.hpp
+ */
+bool BMP280NormalSampler::Fresh(const TP32Data& raw) const
+{
+    return !havelast
+        || raw.temperature != last.temperature
+        || raw.pressure    != last.pressure;
+}
+
+/*
+ * int64_t BMP280NormalSampler::Edge(int64_t deadline, const TP32Data* ref,
+ *                                   TP32Data& raw, bool& late)
+ *
+ * Description:
+ *   Polls until a conversion ends: coarsely (every half conversion
+ *   time) until the measuring bit is seen, then every
+ *   BMP280_SAMPLER_POLL microseconds until it clears or the data
+ *   changes (first poll against ref, later polls against the one
+ *   before). With t_sb = 0.5 ms the bit may be clear for less than a
+ *   poll, so the data change is what shows the edge.
+ *
+ *   If the data changes before the measuring bit has been seen, a
+ *   conversion ended at some unknown time before the poll: late is
+ *   set and that poll's time returned.
+ *
+ * Parameters:
+ *   deadline - give up at this MonotonicNs()
+ *   ref      - the data before the edge, or nullptr if not known
+ *   raw      - receives the reading at the edge
+ *   late     - receives true if the edge time is only an upper bound
+ *
+ * Returns:
+ *   Returns the edge time: midway between the starts of the polls
+ *   either side of it, or the start of the poll that found it when
+ *   late. Returns -1 if the deadline passed first.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sampler.hpp
+ */
+int64_t BMP280NormalSampler::Edge(int64_t deadline, const TP32Data* ref, TP32Data& raw, bool& late)
+{
+    TP32Data prev;
+    int64_t  prevat = 0;
+    bool     seen   = false;
+    bool     first  = true;
+
+    late = false;
+
+    for (;;)
+    {
+        int64_t at = MonotonicNs();
+        uint8_t st = this->Fetch(raw);
+
+        if (seen && !(st & BMP280_STATUS_MEAS))
+            return prevat + (at - prevat)/2;
+
+        // New data with the bit still set: the next conversion has
+        // already begun (short t_sb). The edge was since the last poll.
+        const TP32Data* cmp = first ? ref : &prev;
+        if (cmp != nullptr &&
+            (raw.temperature != cmp->temperature || raw.pressure != cmp->pressure))
+        {
+            late = !seen;
+            return seen ? prevat + (at - prevat)/2 : at;
+        }
+
+        if (st & BMP280_STATUS_MEAS)
+            seen = true;
+
+        first  = false;
+        prev   = raw;
+        prevat = at;
+
+        if (at >= deadline)
+            return -1;
+
+        // Polls are timed from the start of each read, so when a read
+        // takes longer than the poll interval they run back to back.
+        SleepUntil(at + (seen ? (int64_t)BMP280_SAMPLER_POLL * 1000 : meas / 2));
+    }
+}
+
+/*
+ * void BMP280NormalSampler::Resync(int64_t due)
+ *
+ * Description:
+ *   Wakes ahead of the conversion predicted to end at due, polls to
+ *   its edge, and re-estimates the period from the whole conversions
+ *   since the last edge. The reading at the edge becomes pending.
+ *
+ *   If the edge had already passed, the time found is only an upper
+ *   bound: it becomes the new phase, but the period is left alone
+ *   and is measured again at the next conversion. If no conversion
+ *   ends within a period of due, the sampler unlocks.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sampler.hpp
+ */
+void BMP280NormalSampler::Resync(int64_t due)
+{
+    // Wake inside the conversion, well before its end: four polls of
+    // margin once the period is measured, more before.
+    int64_t lead = (int64_t)BMP280_SAMPLER_POLL * 4000 + guard;
+    if (!refined)
+        lead += meas/4 + period/32;
+
+    SleepUntil(due - lead);
+
+    TP32Data raw;
+    bool     late;
+    int64_t  t = this->Edge(due + period, havelast ? &last : nullptr, raw, late);
+
+    if (t < 0)
+    {
+        locked = false;
+        return;
+    }
+
+    resyncs++;
+
+    if (late)
+    {
+        refined = false;
+        syncat  = 1;
+    }
+    else
+    {
+        int64_t n = (int64_t)llround((double)(t - edge) / (double)period);
+        if (n < 1)
+            n = 1;
+
+        // Conversions in between that were not returned repeated the
+        // last reading exactly (see Next()).
+        if (n > count + 1)
+            dupes += (uint64_t)(n - count - 1);
+
+        period  = (t - edge) / n;
+        refined = true;
+        syncat  = (syncat * 2 > BMP280_SAMPLER_SYNC_MAX) ? BMP280_SAMPLER_SYNC_MAX : syncat * 2;
+    }
+
+    edge  = t;
+    count = 0;
+
+    pending     = raw;
+    havepending = true;
+}
+
+} // namespace bosch_bmp280
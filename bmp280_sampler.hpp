@@ -0,0 +1,138 @@
+/*
+ * bmp280_sampler.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Normal-mode sampling, phase-locked to the device's own
+ *    conversion cadence, so each conversion is read exactly once.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_SAMPLER_HPP_
+#define BMP280_SAMPLER_HPP_
+
+#include <stdint.h>          // int64_t, uint64_t
+
+#include "bmp280.hpp"        // BMP280
+#include "bmp280_comp.hpp"   // Cal32Fixed
+#include "bmp280_data.hpp"   // TP32Data
+
+namespace bosch_bmp280
+{
+
+// Status poll interval while locating a conversion edge, us.
+#ifndef BMP280_SAMPLER_POLL
+  #define BMP280_SAMPLER_POLL  250
+#endif
+
+// Most conversions between resyncs, once the period is known.
+#define BMP280_SAMPLER_SYNC_MAX  64
+
+
+/*
+ * class BMP280NormalSampler
+ *
+ * Description:
+ *   Reads a normal-mode device once per conversion, on the device's
+ *   schedule rather than the caller's.
+ *
+ *   Lock() finds the end of a conversion (the status register's
+ *   measuring bit falling) by polling, and starts from the period
+ *   that ctrl_meas and config give (BMP280Config::Period(), the
+ *   maximum). Each Next() then sleeps until just after the predicted
+ *   end of the next conversion and reads the status and data in one
+ *   burst: one transaction per reading.
+ *
+ *   The device's clock is not the host's, and runs faster than the
+ *   datasheet maximum, so every so often (after 1, 2, 4 ... up to
+ *   BMP280_SAMPLER_SYNC_MAX conversions) Next() wakes slightly early
+ *   instead, polls to the falling edge, and refines the period from
+ *   the conversions counted since the last edge. A read that finds
+ *   the data unchanged means the prediction was early; it resyncs at
+ *   once.
+ *
+ *   Raw readings are compared with the last one returned. A read
+ *   that matches it is only returned when timing shows a new
+ *   conversion: the measuring bit was seen to fall, or the read came
+ *   after a predicted edge, once the period has been measured. (A
+ *   real device repeats raw readings often enough at low
+ *   oversampling that dropping every repeat would lose data.)
+ *   Otherwise the read is dropped and the sampler resyncs; if the
+ *   next edge shows a conversion went by unreturned, it repeated the
+ *   last reading. Both count in Duplicates().
+ *
+ *   Call Lock() again after reconfiguring the device. If the device
+ *   is found not converting, Next() re-locks; if that fails, it
+ *   throws.
+ *
+ *   Readings are 32-bit fixed-point compensated, stamped when read.
+ *   The sampler sleeps on BMP280_CLOCK; it is meant to own a thread.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sampler.hpp
+ */
+class BMP280NormalSampler
+{
+  protected:
+    BMP280*     dev;
+    Cal32Fixed  cal;
+
+    int64_t   period;        // conversion period estimate, ns
+    int64_t   meas;          // conversion time, ns (maximum)
+    int64_t   guard;         // read this long after a predicted edge, ns
+    int64_t   edge;          // last measured conversion end, MonotonicNs()
+    int64_t   count;         // conversions read since edge
+    int64_t   syncat;        // resync when count reaches this
+    bool      locked;
+    bool      refined;       // period measured since Lock()
+
+    TP32Data  last;          // last raw reading returned
+    bool      havelast;
+    TP32Data  pending;       // raw reading taken by Lock()/Resync()
+    bool      havepending;
+
+    uint64_t  reads;
+    uint64_t  samples;
+    uint64_t  dupes;
+    uint64_t  resyncs;
+
+    uint8_t  Fetch  ( TP32Data& raw );
+    int64_t  Edge   ( int64_t deadline, const TP32Data* ref, TP32Data& raw, bool& late );
+    void     Resync ( int64_t due );
+    bool     Fresh  ( const TP32Data& raw ) const;
+
+  public:
+
+    BMP280NormalSampler ( BMP280& device );
+
+    void      Lock ();
+    TP32Data  Next ();
+    int       Next ( TP32Data* buf, int count );
+
+    bool      Locked   () const { return locked; }
+    int64_t   PeriodNs () const { return period; }
+    double    Odr      () const { return 1e9 / (double)period; }
+
+    uint64_t  Reads      () const { return reads;   }
+    uint64_t  Samples    () const { return samples; }
+    uint64_t  Duplicates () const { return dupes;   }
+    uint64_t  Resyncs    () const { return resyncs; }
+
+}; // class BMP280NormalSampler
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_SAMPLER_HPP_ */
@@ -0,0 +1,270 @@
+/*
+ * bmp280_sched.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Interleaved acquisition from several BMP280 devices that share
+ *    one I2C bus.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <algorithm>         // sort()
+#include <chrono>            // steady_clock, microseconds
+#include <stdexcept>         // runtime_error
+#include <thread>            // this_thread::sleep_until()
+#include <unistd.h>          // usleep()
+
+#include "bmp280_sched.hpp"  // BMP280BusScheduler
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+/*
+ * BMP280BusScheduler::BMP280BusScheduler(BMP280Bus* devbus, bool pipeline)
+ *
+ * Description:
+ *   Constructor. Creates an empty scheduler for one bus.
+ *
+ * Parameters:
+ *   devbus   - the bus that all scheduled devices are on. Not owned.
+ *   pipeline - optional. If true (the default), forced-mode devices
+ *              are re-triggered as soon as they have been read.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sched.hpp
+ */
+BMP280BusScheduler::BMP280BusScheduler(BMP280Bus* devbus, bool pipeline)
+{
+    bus       = devbus;
+    pipelined = pipeline;
+}
+
+#if BMP280_BBBI2C
+/*
+ * BMP280BusScheduler::BMP280BusScheduler(I2CBus* i2cbus, bool pipeline)
+ *
+ * Description:
+ *   Constructor, for a BeagleBone Black I2C bus. Wraps the I2CBus in
+ *   a BMP280I2CBus of its own.
+ *
+ * Parameters:
+ *   i2cbus   - the bus that all scheduled devices are on. Not owned.
+ *   pipeline - optional. If true (the default), forced-mode devices
+ *              are re-triggered as soon as they have been read.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sched.hpp
+ */
+BMP280BusScheduler::BMP280BusScheduler(I2CBus* i2cbus, bool pipeline)
+    : BMP280BusScheduler(new BMP280I2CBus(i2cbus), pipeline)
+{
+    ownbus.reset(bus);
+}
+#endif
+
+/*
+ * void BMP280BusScheduler::Trigger(Slot& slot)
+ *
+ * Description:
+ *   Starts a forced-mode conversion and records when it will be done.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sched.hpp
+ */
+void BMP280BusScheduler::Trigger(Slot& slot)
+{
+    uint8_t ctrl, conf;
+
+    slot.dev->Force();
+    slot.dev->GetConfig(ctrl, conf);
+
+    slot.due      = Clock::now() + chrono::microseconds(BMP280::MeasureTime(ctrl));
+    slot.inflight = true;
+}
+
+/*
+ * int BMP280BusScheduler::Add(BMP280* dev)
+ *
+ * Description:
+ *   Adds a device to the schedule.
+ *
+ *   Throws a runtime_error exception if the device is on a
+ *   different bus (compared by BMP280Bus::Port()).
+ *
+ * Parameters:
+ *   dev - a configured BMP280 on this scheduler's bus
+ *
+ * Returns:
+ *   Returns the device's index, which identifies its readings.
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sched.hpp
+ */
+int BMP280BusScheduler::Add(BMP280* dev)
+{
+    if (dev->Bus()->Port() != bus->Port())
+    {
+        runtime_error re {"BMP280BusScheduler::Add(): The device is on a different bus."};
+        throw re;
+    }
+
+    Slot slot;
+    slot.dev      = dev;
+    slot.due      = Clock::now();
+    slot.inflight = false;
+    slots.push_back(slot);
+
+    return (int)slots.size() - 1;
+}
+
+/*
+ * int BMP280BusScheduler::Cycle(
+ *         function<void(int index, const TP32Data& reading)> sink)
+ *
+ * Description:
+ *   Takes one compensated reading from every device, as described
+ *   for the class, and hands each one to sink as soon as it is read.
+ *
+ *   Throws a runtime_error exception if a forced conversion does not
+ *   finish within BMP280_T_MEAS_TRIES status polls.
+ *
+ *   If the bus or sink throws, the exception is passed on, and the
+ *   forced-mode devices not read yet are left idle, to be triggered
+ *   again by the next call. A device read before the throw keeps its
+ *   pipelined conversion.
+ *
+ * Parameters:
+ *   sink - called once per device, with the device index and reading
+ *
+ * Returns:
+ *   Returns the number of readings taken.
+ *
+ * Exceptions:
+ *   runtime_error, and whatever sink throws
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sched.hpp
+ */
+int BMP280BusScheduler::Cycle(function<void(int index, const TP32Data& reading)> sink)
+{
+    vector<int> order;
+    order.reserve(slots.size());
+
+    // Normal-mode devices first; they need no trigger or wait.
+    for (int i = 0; i < (int)slots.size(); i++)
+    {
+        uint8_t ctrl, conf;
+        slots[i].dev->GetConfig(ctrl, conf);
+
+        if ((ctrl & BMP280_MODE_MSK) == BMP280_MODE_NORMAL)
+            sink(i, slots[i].dev->GetComp32FixedData());
+        else
+            order.push_back(i);
+    }
+
+    // Readings taken, counted along order. Should anything throw, the
+    // devices not yet read have their conversions written off, and are
+    // triggered afresh next cycle: reading them then would hand back a
+    // conversion up to a cycle old, stamped as new.
+    size_t taken = 0;
+
+    try
+    {
+        for (size_t k = 0; k < order.size(); k++)
+        {
+            Slot& slot = slots[order[k]];
+            if (!slot.inflight)
+                this->Trigger(slot);
+        }
+
+        sort(order.begin(), order.end(),
+             [this](int a, int b) { return slots[a].due < slots[b].due; });
+
+        for (size_t k = 0; k < order.size(); k++)
+        {
+            Slot&    slot = slots[order[k]];
+            TP32Data reading;
+
+            this_thread::sleep_until(slot.due);
+            for (int tries = 0; !slot.dev->ReadForced(reading); tries++)
+            {
+                if (tries >= BMP280_T_MEAS_TRIES)
+                {
+                    runtime_error re {"BMP280BusScheduler::Cycle(): Measurement timed out."};
+                    throw re;
+                }
+                usleep(BMP280_T_MEAS_POLL);
+            }
+            slot.inflight = false;
+            taken = k + 1;
+
+            if (pipelined)
+                this->Trigger(slot);
+
+            sink(order[k], reading);
+        }
+    }
+    catch (...)
+    {
+        for (size_t k = taken; k < order.size(); k++)
+            slots[order[k]].inflight = false;
+        throw;
+    }
+
+    return (int)slots.size();
+}
+
+/*
+ * int BMP280BusScheduler::Cycle(TP32Data* readings)
+ *
+ * Description:
+ *   Takes one compensated reading from every device, as described
+ *   for the class.
+ *
+ * Parameters:
+ *   readings - receives size() readings, indexed by device
+ *
+ * Returns:
+ *   Returns the number of readings taken.
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sched.hpp
+ */
+int BMP280BusScheduler::Cycle(TP32Data* readings)
+{
+    return this->Cycle([readings](int index, const TP32Data& reading) { readings[index] = reading; });
+}
+
+} // namespace bosch_bmp280
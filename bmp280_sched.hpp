@@ -0,0 +1,105 @@
+/*
+ * bmp280_sched.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Interleaved acquisition from several BMP280 devices that share
+ *    one I2C bus.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_SCHED_HPP_
+#define BMP280_SCHED_HPP_
+
+#include <chrono>            // steady_clock
+#include <functional>        // function
+#include <memory>            // unique_ptr
+#include <vector>            // vector
+
+#include "bmp280.hpp"        // BMP280
+#include "bmp280_bus.hpp"    // BMP280Bus
+
+namespace bosch_bmp280
+{
+
+/*
+ * class BMP280BusScheduler
+ *
+ * Description:
+ *   Takes readings from every BMP280 on one bus, overlapping the
+ *   conversion time of each device with bus traffic to the others.
+ *
+ *   Each call to Cycle() takes one reading from every device:
+ *
+ *     1. Every device in forced mode that does not already have a
+ *        conversion running is triggered, back-to-back.
+ *     2. Devices are then read in the order their conversions finish,
+ *        sleeping only until the earliest one is due. Devices in
+ *        normal mode are read straight away.
+ *     3. In pipelined mode, each forced-mode device is triggered
+ *        again as soon as it has been read, so its next conversion
+ *        runs while the rest of this cycle (and whatever the caller
+ *        does between cycles) is going on.
+ *
+ *   With N devices on the bus, a cycle costs about one measurement
+ *   time plus N reads, rather than N measurement times.
+ *
+ *   The scheduler does not own the devices, which must all sit on
+ *   the scheduler's bus and outlive it. Any BMP280Bus will do: a
+ *   BMP280SimBus gives the same interleaving against simulated
+ *   devices, with real conversion times and no hardware.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sched.hpp
+ */
+class BMP280BusScheduler
+{
+  protected:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Slot
+    {
+        BMP280*            dev;
+        Clock::time_point  due;      // conversion finishes
+        bool               inflight; // conversion triggered, not read yet
+    };
+
+    BMP280Bus*         bus;
+    std::unique_ptr<BMP280Bus> ownbus;   // adapter made by the I2CBus constructor
+    std::vector<Slot>  slots;
+    bool               pipelined;
+
+    void  Trigger ( Slot& slot );
+
+  public:
+
+    BMP280BusScheduler ( BMP280Bus* devbus, bool pipeline=true );
+#if BMP280_BBBI2C
+    BMP280BusScheduler ( I2CBus* i2cbus, bool pipeline=true );
+#endif
+
+    int         Add   ( BMP280* dev );
+    int         size  () const { return (int)slots.size(); }
+    BMP280Bus*  Bus   () const { return bus; }
+
+    int   Cycle ( TP32Data* readings );
+    int   Cycle ( std::function<void(int index, const TP32Data& reading)> sink );
+
+}; // class BMP280BusScheduler
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_SCHED_HPP_ */
@@ -0,0 +1,128 @@
+/*
+ * bmp280_seqlock.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Sequence lock: one writer publishes a value, any number of
+ *    readers take consistent copies of it, and nobody waits on a
+ *    mutex.
+ *
+ *  Notes:
+ *    1. The value is held as an array of atomic 32-bit words, loaded
+ *       and stored with relaxed ordering between the fences, so a
+ *       reader that races a writer reads torn words (and retries)
+ *       rather than committing a data race. 32-bit words are
+ *       lock-free on every target this code runs on, the BeagleBone
+ *       included.
+ *    2. The fence placement is the one from Boehm, "Can Seqlocks Get
+ *       Along With Programming Language Memory Models?" (2012).
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_SEQLOCK_HPP_
+#define BMP280_SEQLOCK_HPP_
+
+#include <atomic>            // atomic, atomic_thread_fence()
+#include <cstddef>           // size_t
+#include <cstring>           // memcpy()
+#include <stdint.h>          // uint32_t
+#include <type_traits>       // is_trivially_copyable
+
+namespace bosch_bmp280
+{
+
+/*
+ * template<typename T> class SeqLock
+ *
+ * Description:
+ *   Holds one T. store() never blocks and must only be called from
+ *   one thread at a time. load() never blocks the writer; it copies
+ *   the value and retries if a store() overlapped the copy, so it
+ *   may spin for as long as one store() takes.
+ *
+ *   T must be trivially copyable.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_seqlock.hpp
+ */
+template<typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock: T must be trivially copyable");
+
+  protected:
+    static const size_t words = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t>  seq;          // odd while a store is in progress
+    std::atomic<uint32_t>  data[words];
+
+  public:
+
+    SeqLock () : seq(0)
+    {
+        for (size_t i = 0; i < words; i++)
+            data[i].store(0, std::memory_order_relaxed);
+    }
+
+    SeqLock ( const SeqLock& ) = delete;
+    SeqLock& operator= ( const SeqLock& ) = delete;
+
+    // Publishes v. Single writer only.
+    void store ( const T& v )
+    {
+        uint32_t tmp[words] = {0};
+        std::memcpy(tmp, &v, sizeof(T));
+
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < words; i++)
+            data[i].store(tmp[i], std::memory_order_relaxed);
+
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // Copies the last published value into v. Returns the number of
+    // store() calls it reflects; zero means v is the initial,
+    // all-zero value.
+    uint32_t load ( T& v ) const
+    {
+        uint32_t tmp[words];
+        uint32_t s0, s1;
+
+        do
+        {
+            s0 = seq.load(std::memory_order_acquire);
+            for (size_t i = 0; i < words; i++)
+                tmp[i] = data[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            s1 = seq.load(std::memory_order_relaxed);
+        }
+        while ((s0 & 1) || s0 != s1);
+
+        std::memcpy(&v, tmp, sizeof(T));
+        return s0 >> 1;
+    }
+
+    // Number of store() calls so far.
+    uint32_t version () const { return seq.load(std::memory_order_acquire) >> 1; }
+
+}; // class SeqLock
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_SEQLOCK_HPP_ */
@@ -0,0 +1,468 @@
+/*
+ * bmp280_series.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    A compressed, in-memory history of BMP280 readings.
+ *
+ *  Notes:
+ *    1. Time stamps are stored as the change in the time step
+ *       (delta-of-delta), which is zero, and one byte, for as long as
+ *       readings arrive at a steady rate.
+ *    2. Moment sums are of deviations from the first reading ever
+ *       appended, as in TP32DataQueue, so averages and variances of
+ *       long windows come out without cancellation.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <algorithm>           // lower_bound()
+#include <stdexcept>           // runtime_error
+
+#include "bmp280_series.hpp"   // TP32Series
+#include "bmp280_varint.hpp"   // PutVarint(), GetVarint(), ZigZag()
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+/*
+ * Running totals for a windowed query.
+ */
+struct TP32Series::Totals
+{
+    time_t         tstart, tstop;
+    TP32Aggregate  agg;
+
+    Totals() : tstart(0), tstop(0) { }
+};
+
+
+// TP32Series Constructor
+// -----------------------------------------------------------------
+
+/*
+ * TP32Series::TP32Series(size_t maxreadings)
+ *
+ * Description:
+ *   Constructor.
+ *
+ * Parameters:
+ *   maxreadings - optional. Once more readings than this are held,
+ *                 the oldest chunk is dropped. The default is zero,
+ *                 meaning no limit.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_series.hpp
+ */
+TP32Series::TP32Series(size_t maxreadings)
+{
+    limit  = maxreadings;
+    total  = 0;
+    hasref = false;
+    tref   = 0;
+    pref   = 0;
+
+    lastt     = 0;
+    lastdt    = 0;
+    lasttemp  = 0;
+    lastpress = 0;
+}
+
+
+// TP32Series Protected
+// -----------------------------------------------------------------
+
+/*
+ * template<class F> void TP32Series::Walk(const Chunk& c, F visit) const
+ *
+ * Description:
+ *   Decodes a chunk, calling visit(timestamp, temperature, pressure)
+ *   for each reading in order.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_series.hpp
+ */
+template<class F>
+void TP32Series::Walk(const Chunk& c, F visit) const
+{
+    time_t    t     = c.t0;
+    int64_t   dt    = 0;
+    int32_t   temp  = c.temp0;
+    uint32_t  press = c.press0;
+
+    visit(t, temp, press);
+
+    const uint8_t* p   = c.bytes.data();
+    const uint8_t* end = p + c.bytes.size();
+
+    for (int32_t i = 1; i < c.agg.count; i++)
+    {
+        uint64_t ddt, dtemp, dpress;
+
+        p = GetVarint(p, end, ddt);
+        if (p) p = GetVarint(p, end, dtemp);
+        if (p) p = GetVarint(p, end, dpress);
+        if (!p)
+            return;
+
+        dt   += UnZigZag(ddt);
+        t     = (time_t)((int64_t)t + dt);
+        temp  = (int32_t) ((int64_t)temp  + UnZigZag(dtemp));
+        press = (uint32_t)((int64_t)press + UnZigZag(dpress));
+
+        visit(t, temp, press);
+    }
+}
+
+/*
+ * void TP32Series::Include(const Chunk& c, time_t from, time_t to, Totals& tot) const
+ *
+ * Description:
+ *   Adds the readings of a chunk that fall within [from, to] to a
+ *   set of totals. A chunk entirely within the window is added from
+ *   its summary, without decoding.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_series.hpp
+ */
+void TP32Series::Include(const Chunk& c, time_t from, time_t to, Totals& tot) const
+{
+    if (c.t0 >= from && c.tlast <= to)
+    {
+        if (tot.agg.count == 0) tot.tstart = c.t0;
+        tot.tstop = c.tlast;
+        tot.agg.merge(c.agg);
+        return;
+    }
+
+    int32_t  tr = tref;
+    uint32_t pr = pref;
+
+    this->Walk(c, [&](time_t t, int32_t temp, uint32_t press)
+    {
+        if (t < from || t > to)
+            return;
+
+        if (tot.agg.count == 0) tot.tstart = t;
+        tot.tstop = t;
+        tot.agg.add(temp, press, tr, pr);
+    });
+}
+
+/*
+ * deque<Chunk>::const_iterator TP32Series::First(time_t from) const
+ *
+ * Description:
+ *   Finds the first chunk that has readings at or after from.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_series.hpp
+ */
+deque<TP32Series::Chunk>::const_iterator TP32Series::First(time_t from) const
+{
+    return lower_bound(chunks.begin(), chunks.end(), from,
+                       [](const Chunk& c, time_t t) { return c.tlast < t; });
+}
+
+
+// TP32Series Public
+// -----------------------------------------------------------------
+
+/*
+ * void TP32Series::Append(const TP32Data& reading)
+ *
+ * Description:
+ *   Adds a reading to the end of the series.
+ *
+ * Parameters:
+ *   reading - the reading. Its time stamp must not be earlier than
+ *             that of the last reading appended.
+ *
+ * Exceptions:
+ *   Throws runtime_error if the reading is out of time order.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_series.hpp
+ */
+void TP32Series::Append(const TP32Data& reading)
+{
+    time_t   t     = reading.timestamp;
+    int32_t  temp  = reading.temperature;
+    uint32_t press = reading.pressure;
+
+    if (total > 0 && t < lastt)
+    {
+        runtime_error re {"TP32Series::Append(): Reading is out of time order."};
+        throw re;
+    }
+
+    if (!hasref)
+    {
+        tref   = temp;
+        pref   = press;
+        hasref = true;
+    }
+
+    if (chunks.empty() || chunks.back().agg.count >= BMP280_SERIES_CHUNK)
+    {
+        if (!chunks.empty())
+            chunks.back().bytes.shrink_to_fit();
+
+        chunks.push_back(Chunk());
+        Chunk& c = chunks.back();
+        c.t0     = t;
+        c.temp0  = temp;
+        c.press0 = press;
+        c.bytes.reserve(BMP280_SERIES_CHUNK * 4);
+
+        lastdt = 0;
+    }
+    else
+    {
+        int64_t dt = (int64_t)t - (int64_t)lastt;
+
+        uint8_t  buf[3*BMP280_VARINT_MAX];
+        uint8_t* p = buf;
+        p = PutVarint(p, ZigZag(dt - lastdt));
+        p = PutVarint(p, ZigZag((int64_t)temp  - lasttemp));
+        p = PutVarint(p, ZigZag((int64_t)press - lastpress));
+
+        chunks.back().bytes.insert(chunks.back().bytes.end(), buf, p);
+        lastdt = dt;
+    }
+
+    Chunk& c = chunks.back();
+    c.tlast = t;
+    c.agg.add(temp, press, tref, pref);
+
+    lastt     = t;
+    lasttemp  = temp;
+    lastpress = press;
+    total++;
+
+    while (limit > 0 && total > limit && chunks.size() > 1)
+    {
+        total -= chunks.front().agg.count;
+        chunks.pop_front();
+    }
+}
+
+/*
+ * void TP32Series::Trim(time_t before)
+ *
+ * Description:
+ *   Drops every chunk whose readings are all older than before.
+ *
+ * Parameters:
+ *   before - time stamp to trim to
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_series.hpp
+ */
+void TP32Series::Trim(time_t before)
+{
+    while (!chunks.empty() && chunks.front().tlast < before)
+    {
+        total -= chunks.front().agg.count;
+        chunks.pop_front();
+    }
+}
+
+/*
+ * void TP32Series::clear()
+ *
+ * Description:
+ *   Removes all readings.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_series.hpp
+ */
+void TP32Series::clear()
+{
+    chunks.clear();
+    total  = 0;
+    hasref = false;
+}
+
+/*
+ * int TP32Series::Summarize(time_t from, time_t to,
+ *                           TP32Summary& temp, TP32Summary& press) const
+ *
+ * Description:
+ *   Summarizes the readings with time stamps in [from, to].
+ *
+ * Parameters:
+ *   from  - start of the window, inclusive
+ *   to    - end of the window, inclusive
+ *   temp  - receives the temperature summary
+ *   press - receives the pressure summary
+ *
+ * Returns:
+ *   Returns the number of readings in the window. If it is zero, the
+ *   summaries hold zeroes.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_series.hpp
+ */
+int TP32Series::Summarize(time_t from, time_t to, TP32Summary& temp, TP32Summary& press) const
+{
+    Totals tot;
+
+    for (deque<Chunk>::const_iterator it = First(from); it != chunks.end() && it->t0 <= to; ++it)
+        this->Include(*it, from, to, tot);
+
+    tot.agg.summary(tref, pref, tot.tstart, tot.tstop, temp, press);
+
+    return tot.agg.count;
+}
+
+/*
+ * size_t TP32Series::Extract(time_t from, time_t to, vector<TP32Data>& out) const
+ *
+ * Description:
+ *   Decompresses the readings with time stamps in [from, to], and
+ *   appends them to out.
+ *
+ * Parameters:
+ *   from - start of the window, inclusive
+ *   to   - end of the window, inclusive
+ *   out  - receives the readings
+ *
+ * Returns:
+ *   Returns the number of readings appended.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_series.hpp
+ */
+size_t TP32Series::Extract(time_t from, time_t to, vector<TP32Data>& out) const
+{
+    size_t n = out.size();
+
+    for (deque<Chunk>::const_iterator it = First(from); it != chunks.end() && it->t0 <= to; ++it)
+    {
+        this->Walk(*it, [&](time_t t, int32_t temp, uint32_t press)
+        {
+            if (t < from || t > to)
+                return;
+
+            TP32Data reading(temp, press);
+            reading.timestamp = t;
+            out.push_back(reading);
+        });
+    }
+
+    return out.size() - n;
+}
+
+/*
+ * size_t TP32Series::Bytes() const
+ *
+ * Description:
+ *   Estimates the memory held by the series.
+ *
+ * Returns:
+ *   Returns the size in bytes.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_series.hpp
+ */
+size_t TP32Series::Bytes() const
+{
+    size_t n = sizeof(*this) + chunks.size()*sizeof(Chunk);
+
+    for (deque<Chunk>::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+        n += it->bytes.capacity();
+
+    return n;
+}
+
+/*
+ * time_t TP32Series::timestart() const
+ *
+ * Description:
+ *   Time stamp of the oldest reading.
+ *
+ * Exceptions:
+ *   Throws runtime_error if the series is empty.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_series.hpp
+ */
+time_t TP32Series::timestart() const
+{
+    if (chunks.empty())
+    {
+        runtime_error re {"TP32Series::timestart(): The series is empty."};
+        throw re;
+    }
+
+    return chunks.front().t0;
+}
+
+/*
+ * time_t TP32Series::timestop() const
+ *
+ * Description:
+ *   Time stamp of the newest reading.
+ *
+ * Exceptions:
+ *   Throws runtime_error if the series is empty.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_series.hpp
+ */
+time_t TP32Series::timestop() const
+{
+    if (chunks.empty())
+    {
+        runtime_error re {"TP32Series::timestop(): The series is empty."};
+        throw re;
+    }
+
+    return chunks.back().tlast;
+}
+
+} // namespace bosch_bmp280
@@ -0,0 +1,125 @@
+/*
+ * bmp280_series.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    A compressed, in-memory history of BMP280 readings.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_SERIES_HPP_
+#define BMP280_SERIES_HPP_
+
+#include <cstddef>           // size_t
+#include <ctime>             // time_t
+#include <deque>             // deque
+#include <stdint.h>          // uint8_t, int32_t, uint32_t, int64_t
+#include <vector>            // vector
+
+#include "bmp280_data.hpp"   // TP32Data, TP32Summary, TP32Aggregate
+
+namespace bosch_bmp280
+{
+
+// Readings per compressed chunk.
+#define BMP280_SERIES_CHUNK  256
+
+
+/*
+ * class TP32Series
+ *
+ * Description:
+ *   Holds a long run of readings in a fraction of the memory that
+ *   TP32DataQueue (or an array of TP32Data) would take, for history
+ *   that is kept for days or weeks rather than minutes.
+ *
+ *   Readings are packed into chunks of BMP280_SERIES_CHUNK. Within a
+ *   chunk the first reading is stored whole. After it, each reading is
+ *   stored as zigzag varints (see bmp280_varint.hpp): the change in
+ *   the time step, then the change in temperature and in pressure.
+ *   At a steady sample rate that is typically three or four bytes per
+ *   reading, against sixteen for a TP32Data.
+ *
+ *   Every chunk also keeps its high, low and moment sums, so a
+ *   windowed query only decodes the (at most two) chunks that the
+ *   window boundaries cut through. Chunks entirely inside the window
+ *   are counted from their summaries.
+ *
+ *   Readings must be appended in time stamp order. With a limit set,
+ *   the oldest whole chunk is dropped when the limit is exceeded.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_series.hpp
+ */
+class TP32Series
+{
+  protected:
+    struct Chunk
+    {
+        time_t         t0, tlast;
+        int32_t        temp0;
+        uint32_t       press0;
+        TP32Aggregate  agg;              // every reading in the chunk
+
+        std::vector<uint8_t> bytes;      // readings after the first
+    };
+
+    struct Totals;
+
+    std::deque<Chunk>  chunks;
+    size_t    limit;
+    size_t    total;
+
+    bool      hasref;
+    int32_t   tref;
+    uint32_t  pref;
+
+    // Encoder state: the last reading appended.
+    time_t    lastt;
+    int64_t   lastdt;
+    int32_t   lasttemp;
+    uint32_t  lastpress;
+
+    void  Include ( const Chunk& c, time_t from, time_t to, Totals& tot ) const;
+
+    template<class F>
+    void  Walk ( const Chunk& c, F visit ) const;
+
+    std::deque<Chunk>::const_iterator  First ( time_t from ) const;
+
+  public:
+
+    TP32Series ( size_t maxreadings=0 );
+
+    void    Append ( const TP32Data& reading );
+    void    Trim   ( time_t before );
+    void    clear  ();
+
+    int     Summarize ( time_t from, time_t to, TP32Summary& temp, TP32Summary& press ) const;
+    size_t  Extract   ( time_t from, time_t to, std::vector<TP32Data>& out ) const;
+
+    size_t  size  () const { return total; }
+    bool    empty () const { return total == 0; }
+    size_t  Bytes () const;
+
+    time_t  timestart () const;
+    time_t  timestop  () const;
+
+}; // class TP32Series
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_SERIES_HPP_ */
@@ -0,0 +1,695 @@
+/*
+ * bmp280_sim.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    A simulated BMP280, and a simulated bus to put it on.
+ *
+ *  Notes:
+ *    1. Device state is brought up to date lazily, whenever the bus
+ *       touches the device, from the time of the transfer. An idle
+ *       device costs nothing, so thousands of them can sit on a
+ *       workstation.
+ *    2. A normal-mode device that has not been read for several
+ *       cycles latches once per missed cycle (up to 32), so the IIR
+ *       filter settles as it would on the real part.
+ *    3. Raw readings for an environment are found by binary search on
+ *       the Cal32Fixed compensation kernels, which are monotonic in
+ *       their raw inputs.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <chrono>              // nanoseconds
+#include <cmath>               // lround()
+#include <cstring>             // memcpy(), memset()
+#include <stdexcept>           // runtime_error
+#include <thread>              // this_thread::sleep_for()
+
+#include "bmp280_comp.hpp"     // Cal32Fixed
+#include "bmp280_config.hpp"   // BMP280Config, OsrsSamples(), StandbyTime()
+#include "bmp280_data.hpp"     // CalParams, MonotonicNs()
+#include "bmp280_sim.hpp"      // BMP280Sim, BMP280SimBus
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+// Datasheet example calibration (section 3.12), as read from the ROM.
+static const uint8_t SimCalRaw[BMP280_CAL_SIZE] =
+{
+    0x70, 0x6B,  0x43, 0x67,  0x18, 0xFC,              // t1, t2, t3
+    0x7D, 0x8E,  0x43, 0xD6,  0xD0, 0x0B,  0x27, 0x0B, // p1 .. p4
+    0x8C, 0x00,  0xF9, 0xFF,  0x8C, 0x3C,  0xF8, 0xC6, // p5 .. p8
+    0x70, 0x17                                         // p9
+};
+
+#define BMP280_SIM_SKIPPED   0x80000     // data registers, measurement skipped
+#define BMP280_SIM_CATCHUP   32          // most latches for missed cycles
+
+
+// BMP280Sim Constructor
+// -----------------------------------------------------------------
+
+/*
+ * BMP280Sim::BMP280Sim()
+ *
+ * Description:
+ *   Constructor. A powered-on device in sleep mode, with the
+ *   datasheet calibration, no noise, and the datasheet example
+ *   environment (25.08 degC, 100653 Pa).
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+BMP280Sim::BMP280Sim()
+{
+    memset(regs, 0, sizeof(regs));
+    memcpy(regs + BMP280_R_CAL_T1L, SimCalRaw, BMP280_CAL_SIZE);
+
+    adct  = 519888;
+    adcp  = 415148;
+    noise = 0;
+    lcg   = 1;
+
+    conversions = 0;
+
+    this->PowerOn();
+}
+
+
+// BMP280Sim Protected
+// -----------------------------------------------------------------
+
+/*
+ * int64_t BMP280Sim::MeasureNs() const
+ *
+ * Description:
+ *   Typical conversion time for the current ctrl_meas, nanoseconds.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+int64_t BMP280Sim::MeasureNs() const
+{
+    BMP280Config cfg = BMP280Config::FromRegs(regs[BMP280_R_CTRL], regs[BMP280_R_CONF]);
+    int nt = OsrsSamples(cfg.ost);
+    int np = OsrsSamples(cfg.osp);
+    int64_t us = BMP280_SIM_T_BASE + BMP280_SIM_T_OS*nt
+               + (np > 0 ? BMP280_SIM_T_OS*np + BMP280_SIM_T_PRESS : 0);
+
+    return us * 1000;
+}
+
+/*
+ * int64_t BMP280Sim::PeriodNs() const
+ *
+ * Description:
+ *   Normal-mode cycle time, conversion plus standby, nanoseconds.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+int64_t BMP280Sim::PeriodNs() const
+{
+    BMP280Config cfg = BMP280Config::FromRegs(regs[BMP280_R_CTRL], regs[BMP280_R_CONF]);
+
+    return this->MeasureNs() + (int64_t)StandbyTime(cfg.tsb) * 1000;
+}
+
+/*
+ * void BMP280Sim::Update(int64_t now)
+ *
+ * Description:
+ *   Finishes any conversions due by now, and sets status.measuring.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280Sim::Update(int64_t now)
+{
+    uint8_t mode = regs[BMP280_R_CTRL] & BMP280_MODE_MSK;
+    bool    meas = false;
+
+    if (converting)
+    {
+        if (now >= convdone)
+        {
+            this->Latch();
+            converting = false;
+            regs[BMP280_R_CTRL] &= BMP280_MODE_MSK_OUT;
+        }
+        else
+            meas = true;
+    }
+    else if (mode == BMP280_MODE_NORMAL)
+    {
+        if (now >= convdone)
+        {
+            int64_t period = this->PeriodNs();
+            int64_t missed = (now - convdone) / period;
+
+            // Latch() counts the ones it does; count the rest here.
+            for (int64_t i = 0; i <= missed && i < BMP280_SIM_CATCHUP; i++)
+                this->Latch();
+            if (missed >= BMP280_SIM_CATCHUP)
+                conversions += (uint64_t)(missed + 1 - BMP280_SIM_CATCHUP);
+
+            convstart += (missed + 1) * period;
+            convdone   = convstart + this->MeasureNs();
+        }
+        meas = (now >= convstart && now < convdone);
+    }
+
+    regs[BMP280_R_STAT] = meas ? BMP280_STATUS_MEAS : 0;
+}
+
+/*
+ * void BMP280Sim::Latch()
+ *
+ * Description:
+ *   Completes one conversion: samples the environment, truncates to
+ *   the resolution of the oversampling setting, filters, and writes
+ *   the data registers.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280Sim::Latch()
+{
+    BMP280Config cfg = BMP280Config::FromRegs(regs[BMP280_R_CTRL], regs[BMP280_R_CONF]);
+    int32_t coef = 1 << ((int)cfg.filter > 4 ? 4 : (int)cfg.filter);
+    int32_t v[2] = { adcp, adct };
+    Osrs    os[2] = { cfg.osp, cfg.ost };
+    int32_t out[2];
+
+    for (int k = 0; k < 2; k++)
+    {
+        if (noise > 0)
+        {
+            lcg = lcg*1664525u + 1013904223u;
+            v[k] += (int32_t)((lcg >> 8) % (uint32_t)(2*noise + 1)) - noise;
+        }
+        if (v[k] < 0)       v[k] = 0;
+        if (v[k] > 0xFFFFF) v[k] = 0xFFFFF;
+
+        // 16 bits at x1, one more for each step, 20 at x16 and above.
+        if (os[k] != Osrs::Skip && (int)os[k] < 5)
+            v[k] &= ~((1 << (5 - (int)os[k])) - 1);
+    }
+
+    if (filtempty || coef == 1)
+    {
+        filtp = v[0];
+        filtt = v[1];
+        filtempty = false;
+    }
+    else
+    {
+        filtp += (v[0] - filtp) / coef;
+        filtt += (v[1] - filtt) / coef;
+    }
+
+    out[0] = (cfg.osp == Osrs::Skip) ? BMP280_SIM_SKIPPED : filtp;
+    out[1] = (cfg.ost == Osrs::Skip) ? BMP280_SIM_SKIPPED : filtt;
+
+    for (int k = 0; k < 2; k++)
+    {
+        uint8_t* r = regs + (k == 0 ? BMP280_R_PMSB : BMP280_R_TMSB);
+        r[0] = (uint8_t)(out[k] >> 12);
+        r[1] = (uint8_t)(out[k] >> 4);
+        r[2] = (uint8_t)(out[k] << 4);
+    }
+
+    conversions++;
+}
+
+/*
+ * void BMP280Sim::Start(int64_t now)
+ *
+ * Description:
+ *   Acts on a new ctrl_meas: starts a forced conversion, starts
+ *   normal-mode cycling, or stops.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280Sim::Start(int64_t now)
+{
+    uint8_t mode = regs[BMP280_R_CTRL] & BMP280_MODE_MSK;
+
+    converting = (mode == BMP280_MODE_FORCED || mode == 0x02);
+    convstart  = now;
+    convdone   = now + this->MeasureNs();
+}
+
+/*
+ * void BMP280Sim::PowerOn()
+ *
+ * Description:
+ *   Power-on (and soft reset) state: sleep mode, config cleared,
+ *   data registers at their reset value. Calibration is kept.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280Sim::PowerOn()
+{
+    regs[BMP280_R_ID]   = BMP280_ID;
+    regs[BMP280_R_STAT] = 0;
+    regs[BMP280_R_CTRL] = 0;
+    regs[BMP280_R_CONF] = 0;
+
+    for (int k = 0; k < 2; k++)
+    {
+        uint8_t* r = regs + (k == 0 ? BMP280_R_PMSB : BMP280_R_TMSB);
+        r[0] = 0x80;
+        r[1] = 0x00;
+        r[2] = 0x00;
+    }
+
+    filtt = filtp = 0;
+    filtempty  = true;
+    converting = false;
+    convstart  = 0;
+    convdone   = 0;
+}
+
+
+// BMP280Sim Public
+// -----------------------------------------------------------------
+
+/*
+ * void BMP280Sim::SetCalRaw(const uint8_t* calraw)
+ *
+ * Description:
+ *   Replaces the calibration ROM. The environment is not recomputed;
+ *   call SetEnvironment() afterwards.
+ *
+ * Parameters:
+ *   calraw - BMP280_CAL_SIZE bytes, laid out as in the device
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280Sim::SetCalRaw(const uint8_t* calraw)
+{
+    memcpy(regs + BMP280_R_CAL_T1L, calraw, BMP280_CAL_SIZE);
+}
+
+/*
+ * void BMP280Sim::GetCalRaw(uint8_t* calraw) const
+ *
+ * Description:
+ *   Copies out the calibration ROM.
+ *
+ * Parameters:
+ *   calraw - receives BMP280_CAL_SIZE bytes
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280Sim::GetCalRaw(uint8_t* calraw) const
+{
+    memcpy(calraw, regs + BMP280_R_CAL_T1L, BMP280_CAL_SIZE);
+}
+
+/*
+ * void BMP280Sim::SetEnvironment(double celsius, double pascals)
+ *
+ * Description:
+ *   Sets the conditions the device measures from the next conversion
+ *   on: the raw readings that compensate, with this device's
+ *   calibration, to the nearest values at or beyond these.
+ *
+ * Parameters:
+ *   celsius - temperature, degrees centigrade
+ *   pascals - pressure, pascals
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280Sim::SetEnvironment(double celsius, double pascals)
+{
+    const uint8_t* dat = regs + BMP280_R_CAL_T1L;
+    CalParams cp;
+
+    cp.t1 = ((uint16_t)dat[BMP280_CAL_T1H_NDX] << 8) | (uint16_t)dat[BMP280_CAL_T1L_NDX];
+    cp.t2 = (( int16_t)dat[BMP280_CAL_T2H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_T2L_NDX];
+    cp.t3 = (( int16_t)dat[BMP280_CAL_T3H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_T3L_NDX];
+    cp.p1 = ((uint16_t)dat[BMP280_CAL_P1H_NDX] << 8) | (uint16_t)dat[BMP280_CAL_P1L_NDX];
+    cp.p2 = (( int16_t)dat[BMP280_CAL_P2H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_P2L_NDX];
+    cp.p3 = (( int16_t)dat[BMP280_CAL_P3H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_P3L_NDX];
+    cp.p4 = (( int16_t)dat[BMP280_CAL_P4H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_P4L_NDX];
+    cp.p5 = (( int16_t)dat[BMP280_CAL_P5H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_P5L_NDX];
+    cp.p6 = (( int16_t)dat[BMP280_CAL_P6H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_P6L_NDX];
+    cp.p7 = (( int16_t)dat[BMP280_CAL_P7H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_P7L_NDX];
+    cp.p8 = (( int16_t)dat[BMP280_CAL_P8H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_P8L_NDX];
+    cp.p9 = (( int16_t)dat[BMP280_CAL_P9H_NDX] << 8) | ( int16_t)dat[BMP280_CAL_P9L_NDX];
+    cp.loaded = true;
+
+    Cal32Fixed cal(cp);
+    int32_t tgt = (int32_t)lround(celsius * 100.0);
+    int32_t pgt = (int32_t)lround(pascals);
+    int32_t lo, hi, tf;
+
+    // Smallest raw temperature that compensates to tgt or above.
+    lo = 0;  hi = 0xFFFFF;
+    while (lo < hi)
+    {
+        int32_t mid = lo + (hi - lo)/2;
+        if (cal.Temp(mid, tf) < tgt) lo = mid + 1; else hi = mid;
+    }
+    adct = lo;
+    cal.Temp(adct, tf);
+
+    // Pressure falls as the raw reading rises: smallest raw pressure
+    // that compensates to pgt or below.
+    lo = 0;  hi = 0xFFFFF;
+    while (lo < hi)
+    {
+        int32_t mid = lo + (hi - lo)/2;
+        if ((int32_t)cal.Press((uint32_t)mid, tf) > pgt) lo = mid + 1; else hi = mid;
+    }
+    adcp = lo;
+}
+
+/*
+ * void BMP280Sim::SetNoise(int counts)
+ *
+ * Description:
+ *   Adds uniform noise of up to +/- counts to every raw sample,
+ *   before the resolution and filter are applied.
+ *
+ * Parameters:
+ *   counts - noise amplitude, in 20-bit raw counts. Zero for none.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280Sim::SetNoise(int counts)
+{
+    noise = (counts > 0) ? counts : 0;
+}
+
+/*
+ * void BMP280Sim::Read(int64_t now, uint8_t reg, uint8_t* data, int len)
+ *
+ * Description:
+ *   A register read at time now, with address auto-increment.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280Sim::Read(int64_t now, uint8_t reg, uint8_t* data, int len)
+{
+    this->Update(now);
+
+    for (int i = 0; i < len; i++)
+        data[i] = regs[(uint8_t)(reg + i)];
+}
+
+/*
+ * void BMP280Sim::Write(int64_t now, const uint8_t* data, int len)
+ *
+ * Description:
+ *   {register, value} pair writes at time now. Only ctrl_meas,
+ *   config and reset are writable; writes elsewhere are ignored,
+ *   as on the device.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280Sim::Write(int64_t now, const uint8_t* data, int len)
+{
+    this->Update(now);
+
+    for (int i = 0; i + 1 < len; i += 2)
+    {
+        uint8_t reg = data[i];
+        uint8_t val = data[i + 1];
+
+        if (reg == BMP280_R_RESET)
+        {
+            if (val == BMP280_CMD_RESET)
+                this->PowerOn();
+        }
+        else if (reg == BMP280_R_CTRL)
+        {
+            regs[BMP280_R_CTRL] = val;
+            this->Start(now);
+        }
+        else if (reg == BMP280_R_CONF)
+        {
+            regs[BMP280_R_CONF] = val;
+        }
+    }
+}
+
+
+// BMP280SimBus
+// -----------------------------------------------------------------
+
+/*
+ * BMP280SimBus::BMP280SimBus(unsigned int xferns, unsigned int bytens)
+ *
+ * Description:
+ *   Constructor. An empty bus.
+ *
+ * Parameters:
+ *   xferns - optional. Bus time per transfer, nanoseconds. Default 0.
+ *   bytens - optional. Bus time per byte, nanoseconds. Default 0.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+BMP280SimBus::BMP280SimBus(unsigned int xferns, unsigned int bytens)
+    : latxfer(xferns), latbyte(bytens), xfers(0), bytes(0)
+{ }
+
+/*
+ * BMP280Sim& BMP280SimBus::Find(uint8_t addr)
+ *
+ * Description:
+ *   Looks up a device, throwing a runtime_error if there is none.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+BMP280Sim& BMP280SimBus::Find(uint8_t addr)
+{
+    if (addr >= 128 || !devs[addr])
+    {
+        runtime_error re {"BMP280SimBus::Find(): No device at that address."};
+        throw re;
+    }
+
+    return *devs[addr];
+}
+
+/*
+ * void BMP280SimBus::Hold(int64_t start, int count)
+ *
+ * Description:
+ *   Keeps the bus busy until the transfer that began at start, moving
+ *   count bytes, would be over.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280SimBus::Hold(int64_t start, int count)
+{
+    int64_t ns = (int64_t)latxfer + (int64_t)latbyte * count;
+
+    xfers++;
+    bytes += (uint64_t)count;
+
+    if (ns <= 0)
+        return;
+
+    int64_t left = start + ns - MonotonicNs();
+    if (left > 0)
+        this_thread::sleep_for(chrono::nanoseconds(left));
+}
+
+/*
+ * BMP280Sim& BMP280SimBus::Add(uint8_t addr)
+ *
+ * Description:
+ *   Puts a new simulated device on the bus.
+ *
+ * Parameters:
+ *   addr - its address, 0 to 127
+ *
+ * Returns:
+ *   Returns the device, for setting its environment.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if the address is out of range or taken.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+BMP280Sim& BMP280SimBus::Add(uint8_t addr)
+{
+    lock_guard<mutex> lock(busmtx);
+
+    if (addr >= 128 || devs[addr])
+    {
+        runtime_error re {"BMP280SimBus::Add(): Address out of range or in use."};
+        throw re;
+    }
+
+    devs[addr].reset(new BMP280Sim());
+    return *devs[addr];
+}
+
+/*
+ * BMP280Sim& BMP280SimBus::Device(uint8_t addr)
+ *
+ * Description:
+ *   Retrieves a device. Changing it while another thread is using
+ *   the bus is up to the caller to arrange.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if there is no device at addr.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+BMP280Sim& BMP280SimBus::Device(uint8_t addr)
+{
+    lock_guard<mutex> lock(busmtx);
+
+    return this->Find(addr);
+}
+
+/*
+ * void BMP280SimBus::SetLatency(unsigned int xferns, unsigned int bytens)
+ *
+ * Description:
+ *   Sets the bus time per transfer and per byte, in nanoseconds.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280SimBus::SetLatency(unsigned int xferns, unsigned int bytens)
+{
+    lock_guard<mutex> lock(busmtx);
+
+    latxfer = xferns;
+    latbyte = bytens;
+}
+
+/*
+ * void BMP280SimBus::Read(uint8_t addr, uint8_t reg, uint8_t* data, int len)
+ *
+ * Description:
+ *   BMP280Bus::Read(), against the simulated device at addr.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if there is no device at addr.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280SimBus::Read(uint8_t addr, uint8_t reg, uint8_t* data, int len)
+{
+    lock_guard<mutex> lock(busmtx);
+    int64_t now = MonotonicNs();
+
+    this->Find(addr).Read(now, reg, data, len);
+    this->Hold(now, len + 1);
+}
+
+/*
+ * void BMP280SimBus::Write(uint8_t addr, uint8_t* data, int len)
+ *
+ * Description:
+ *   BMP280Bus::Write(), against the simulated device at addr.
+ *
+ * Exceptions:
+ *   Throws a runtime_error if there is no device at addr.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+void BMP280SimBus::Write(uint8_t addr, uint8_t* data, int len)
+{
+    lock_guard<mutex> lock(busmtx);
+    int64_t now = MonotonicNs();
+
+    this->Find(addr).Write(now, data, len);
+    this->Hold(now, len);
+}
+
+} // namespace bosch_bmp280
@@ -0,0 +1,171 @@
+/*
+ * bmp280_sim.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    A simulated BMP280, and a simulated bus to put it on, for
+ *    exercising drivers, schedulers and queues without hardware.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_SIM_HPP_
+#define BMP280_SIM_HPP_
+
+#include <atomic>            // atomic
+#include <memory>            // unique_ptr
+#include <mutex>             // mutex
+#include <stdint.h>          // uint8_t, int32_t, uint32_t, int64_t, uint64_t
+
+#include "bmp280_bus.hpp"    // BMP280Bus
+#include "bmp280_defs.hpp"   // BMP280_CAL_SIZE
+
+namespace bosch_bmp280
+{
+
+// Typical conversion time, in microseconds (datasheet, section 9.1):
+//   base + os*(osrs_t samples) + os*(osrs_p samples) + press
+// The driver waits for the maximum (BMP280_T_MEAS_*), so a simulated
+// device is always done by the time the driver looks.
+#define BMP280_SIM_T_BASE    1000
+#define BMP280_SIM_T_OS      2000
+#define BMP280_SIM_T_PRESS    500
+
+
+/*
+ * class BMP280Sim
+ *
+ * Description:
+ *   One simulated device: the register map, calibration ROM and
+ *   conversion behaviour of a BMP280.
+ *
+ *     - Calibration is the datasheet example unless SetCalRaw() is
+ *       called. The chip id reads BMP280_ID.
+ *     - Writing ctrl_meas starts a forced conversion, or normal-mode
+ *       cycling, with conversion times from osrs_t and osrs_p and
+ *       standby times from t_sb. status.measuring is set while a
+ *       conversion runs, and the data registers change only when one
+ *       finishes. A forced conversion returns the device to sleep.
+ *     - The data registers hold the readings that compensate to the
+ *       environment set by SetEnvironment(), plus optional noise,
+ *       truncated to the resolution osrs gives, passed through the
+ *       IIR filter, or 0x80000 for a skipped measurement.
+ *     - Writing BMP280_CMD_RESET to the reset register restores the
+ *       power-on state.
+ *
+ *   Times are BMP280_CLOCK nanoseconds (see MonotonicNs()), passed in
+ *   by the bus, so conversions run in real time.
+ *
+ *   Not thread-safe on its own; the BMP280SimBus it is on serializes
+ *   access.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+class BMP280Sim
+{
+  protected:
+    uint8_t   regs[256];
+
+    int32_t   adct;                  // noiseless raw readings, from the environment
+    int32_t   adcp;
+    int32_t   filtt, filtp;          // IIR filter state, raw counts
+    bool      filtempty;
+    int       noise;                 // +/- raw counts
+    uint32_t  lcg;
+
+    bool      converting;            // forced conversion running
+    int64_t   convstart;             // current conversion (or cycle) start
+    int64_t   convdone;              // current conversion end
+    uint64_t  conversions;
+
+    int64_t  MeasureNs () const;
+    int64_t  PeriodNs  () const;
+    void     Update    ( int64_t now );
+    void     Latch     ();
+    void     Start     ( int64_t now );
+    void     PowerOn   ();
+
+  public:
+
+    BMP280Sim ();
+
+    void  SetCalRaw      ( const uint8_t* calraw );
+    void  GetCalRaw      ( uint8_t* calraw ) const;
+    void  SetEnvironment ( double celsius, double pascals );
+    void  SetNoise       ( int counts );
+
+    void  Read  ( int64_t now, uint8_t reg, uint8_t* data, int len );
+    void  Write ( int64_t now, const uint8_t* data, int len );
+
+    uint64_t  Conversions () const { return conversions; }
+
+}; // class BMP280Sim
+
+
+/*
+ * class BMP280SimBus
+ *
+ * Description:
+ *   A BMP280Bus with simulated devices on it. A transfer to an
+ *   address with no device throws a runtime_error, as a NACK would.
+ *
+ *   Every transfer holds the bus, serialized by a mutex, for
+ *   xferns + bytens per byte moved (register address and data),
+ *   sleeping for it. At 400 kHz I2C that is about 50000 and 22500.
+ *   Both default to zero: as fast as the host allows.
+ *
+ *   Transfers() and Bytes() count the traffic, since construction.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_sim.hpp
+ */
+class BMP280SimBus : public BMP280Bus
+{
+  protected:
+    std::unique_ptr<BMP280Sim>  devs[128];
+    std::mutex                  busmtx;
+    unsigned int                latxfer;
+    unsigned int                latbyte;
+
+    std::atomic<uint64_t>  xfers;
+    std::atomic<uint64_t>  bytes;
+
+    BMP280Sim&  Find ( uint8_t addr );
+    void        Hold ( int64_t start, int count );
+
+  public:
+
+    BMP280SimBus ( unsigned int xferns=0, unsigned int bytens=0 );
+
+    BMP280Sim&  Add    ( uint8_t addr );
+    BMP280Sim&  Device ( uint8_t addr );
+
+    void  SetLatency ( unsigned int xferns, unsigned int bytens );
+
+    void  Read  ( uint8_t addr, uint8_t reg, uint8_t* data, int len ) override;
+    void  Write ( uint8_t addr, uint8_t* data, int len ) override;
+
+    uint64_t  Transfers () const { return xfers.load(); }
+    uint64_t  Bytes     () const { return bytes.load(); }
+
+}; // class BMP280SimBus
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_SIM_HPP_ */
@@ -0,0 +1,647 @@
+/*
+ * bmp280_simd.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Vectorized kernels for compensating and summarizing columns of
+ *    BMP280 readings.
+ *
+ *  Notes:
+ *    1. Each kernel processes four 32-bit lanes per step. Deviations
+ *       from the reference value are summed and squared into 64-bit
+ *       lanes, so neither total can overflow for any realistic window.
+ *    2. Any elements left over after the last full vector are handled
+ *       by the scalar loop at the bottom of each kernel, which is also
+ *       the whole kernel when neither NEON nor SSE4.1 is available.
+ *    3. There is no integer vector divide on any of these targets, so
+ *       the compensation kernel divides with doubles on x86, which is
+ *       exact for 32-bit operands (see DivideLanes()). On ARM the
+ *       division pass stays scalar.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <cstddef>           // size_t
+#include <stdint.h>          // int32_t, uint32_t, int64_t
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define BMP280_SIMD_NEON
+#elif defined(__SSE4_1__)
+  #include <smmintrin.h>
+  #define BMP280_SIMD_SSE41
+  #if defined(__AVX2__)
+    #include <immintrin.h>
+    #define BMP280_SIMD_AVX2
+  #endif
+#endif
+
+// Readings per pass of Comp32FixedBatch(). Sized so the scratch
+// columns stay in L1.
+#define BMP280_COMP_CHUNK  64
+
+#include "bmp280_simd.hpp"
+
+namespace bosch_bmp280
+{
+
+#if defined(BMP280_SIMD_SSE41)
+/*
+ * Adds the squares of four signed 32-bit lanes into two 64-bit lanes.
+ * _mm_mul_epi32 only multiplies the even lanes, so the odd lanes are
+ * shifted down for a second multiply.
+ */
+static inline __m128i AddSquares(__m128i acc, __m128i d)
+{
+    __m128i odd = _mm_srli_epi64(d, 32);
+    acc = _mm_add_epi64(acc, _mm_mul_epi32(d, d));
+    acc = _mm_add_epi64(acc, _mm_mul_epi32(odd, odd));
+    return acc;
+}
+
+/*
+ * Adds four signed 32-bit lanes into two 64-bit lanes.
+ */
+static inline __m128i AddWidened(__m128i acc, __m128i d)
+{
+    acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(d));
+    acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(d, 8)));
+    return acc;
+}
+
+/*
+ * Adds the two 64-bit lanes of a vector.
+ */
+static inline int64_t AddLanes(__m128i v)
+{
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, v);
+    return lanes[0] + lanes[1];
+}
+#endif
+
+/*
+ * void SummarizeI32(const int32_t* data, size_t len, int32_t ref,
+ *                   int32_t& high, int32_t& low,
+ *                   int64_t& sum,  int64_t& sumsq)
+ *
+ * Description:
+ *   Finds the highest and lowest values in an array of signed 32-bit
+ *   integers, and totals their deviations from a reference value
+ *   along with the squares of those deviations, all in one pass.
+ *
+ *   Results are accumulated: high and low are only replaced by more
+ *   extreme values, and the array totals are added to sum and sumsq.
+ *
+ *   Choosing a reference near the data (the first reading, say)
+ *   keeps the squares small, so that a variance computed from sum
+ *   and sumsq does not lose precision to cancellation.
+ *
+ * Parameters:
+ *   data  - pointer to the first element
+ *   len   - the number of elements
+ *   ref   - reference value. Each deviation (data[i] - ref) must fit
+ *           in 32 bits.
+ *   high  - in/out. Highest value seen so far.
+ *   low   - in/out. Lowest value seen so far.
+ *   sum   - in/out. Running total of (data[i] - ref).
+ *   sumsq - in/out. Running total of (data[i] - ref) squared.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_simd.hpp
+ */
+void SummarizeI32(const int32_t* data, size_t len, int32_t ref,
+                  int32_t& high, int32_t& low, int64_t& sum, int64_t& sumsq)
+{
+    size_t i = 0;
+
+#if defined(BMP280_SIMD_NEON)
+    if (len >= 4)
+    {
+        int32x4_t vhi  = vdupq_n_s32(high);
+        int32x4_t vlo  = vdupq_n_s32(low);
+        int32x4_t vref = vdupq_n_s32(ref);
+        int64x2_t vsum = vdupq_n_s64(0);
+        int64x2_t vsq  = vdupq_n_s64(0);
+
+        for (; i + 4 <= len; i += 4)
+        {
+            int32x4_t v = vld1q_s32(data + i);
+            int32x4_t d = vsubq_s32(v, vref);
+            vhi  = vmaxq_s32(vhi, v);
+            vlo  = vminq_s32(vlo, v);
+            vsum = vpadalq_s32(vsum, d);
+            vsq  = vmlal_s32(vsq, vget_low_s32(d),  vget_low_s32(d));
+            vsq  = vmlal_s32(vsq, vget_high_s32(d), vget_high_s32(d));
+        }
+
+        int32x2_t h = vpmax_s32(vget_low_s32(vhi), vget_high_s32(vhi));
+        int32x2_t l = vpmin_s32(vget_low_s32(vlo), vget_high_s32(vlo));
+        h = vpmax_s32(h, h);
+        l = vpmin_s32(l, l);
+
+        high   = vget_lane_s32(h, 0);
+        low    = vget_lane_s32(l, 0);
+        sum   += vgetq_lane_s64(vsum, 0) + vgetq_lane_s64(vsum, 1);
+        sumsq += vgetq_lane_s64(vsq,  0) + vgetq_lane_s64(vsq,  1);
+    }
+#elif defined(BMP280_SIMD_SSE41)
+    if (len >= 4)
+    {
+        __m128i vhi  = _mm_set1_epi32(high);
+        __m128i vlo  = _mm_set1_epi32(low);
+        __m128i vref = _mm_set1_epi32(ref);
+        __m128i vsum = _mm_setzero_si128();
+        __m128i vsq  = _mm_setzero_si128();
+
+        for (; i + 4 <= len; i += 4)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+            __m128i d = _mm_sub_epi32(v, vref);
+            vhi  = _mm_max_epi32(vhi, v);
+            vlo  = _mm_min_epi32(vlo, v);
+            vsum = AddWidened(vsum, d);
+            vsq  = AddSquares(vsq, d);
+        }
+
+        vhi = _mm_max_epi32(vhi, _mm_shuffle_epi32(vhi, _MM_SHUFFLE(1,0,3,2)));
+        vhi = _mm_max_epi32(vhi, _mm_shuffle_epi32(vhi, _MM_SHUFFLE(2,3,0,1)));
+        vlo = _mm_min_epi32(vlo, _mm_shuffle_epi32(vlo, _MM_SHUFFLE(1,0,3,2)));
+        vlo = _mm_min_epi32(vlo, _mm_shuffle_epi32(vlo, _MM_SHUFFLE(2,3,0,1)));
+
+        high   = _mm_cvtsi128_si32(vhi);
+        low    = _mm_cvtsi128_si32(vlo);
+        sum   += AddLanes(vsum);
+        sumsq += AddLanes(vsq);
+    }
+#endif
+
+    for (; i < len; i++)
+    {
+        int32_t v = data[i];
+        int32_t d = (int32_t)((uint32_t)v - (uint32_t)ref);
+        if (v > high) high = v;
+        if (v < low)  low  = v;
+        sum   += d;
+        sumsq += (int64_t)d * d;
+    }
+}
+
+/*
+ * void SummarizeU32(const uint32_t* data, size_t len, uint32_t ref,
+ *                   uint32_t& high, uint32_t& low,
+ *                   int64_t& sum,   int64_t& sumsq)
+ *
+ * Description:
+ *   Finds the highest and lowest values in an array of unsigned 32-bit
+ *   integers, and totals their deviations from a reference value
+ *   along with the squares of those deviations, all in one pass.
+ *
+ *   Results are accumulated: high and low are only replaced by more
+ *   extreme values, and the array totals are added to sum and sumsq.
+ *
+ * Parameters:
+ *   data  - pointer to the first element
+ *   len   - the number of elements
+ *   ref   - reference value. Each deviation (data[i] - ref) must fit
+ *           in a signed 32-bit integer.
+ *   high  - in/out. Highest value seen so far.
+ *   low   - in/out. Lowest value seen so far.
+ *   sum   - in/out. Running total of (data[i] - ref).
+ *   sumsq - in/out. Running total of (data[i] - ref) squared.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_simd.hpp
+ */
+void SummarizeU32(const uint32_t* data, size_t len, uint32_t ref,
+                  uint32_t& high, uint32_t& low, int64_t& sum, int64_t& sumsq)
+{
+    size_t i = 0;
+
+#if defined(BMP280_SIMD_NEON)
+    if (len >= 4)
+    {
+        uint32x4_t vhi  = vdupq_n_u32(high);
+        uint32x4_t vlo  = vdupq_n_u32(low);
+        uint32x4_t vref = vdupq_n_u32(ref);
+        int64x2_t  vsum = vdupq_n_s64(0);
+        int64x2_t  vsq  = vdupq_n_s64(0);
+
+        for (; i + 4 <= len; i += 4)
+        {
+            uint32x4_t v = vld1q_u32(data + i);
+            int32x4_t  d = vreinterpretq_s32_u32(vsubq_u32(v, vref));
+            vhi  = vmaxq_u32(vhi, v);
+            vlo  = vminq_u32(vlo, v);
+            vsum = vpadalq_s32(vsum, d);
+            vsq  = vmlal_s32(vsq, vget_low_s32(d),  vget_low_s32(d));
+            vsq  = vmlal_s32(vsq, vget_high_s32(d), vget_high_s32(d));
+        }
+
+        uint32x2_t h = vpmax_u32(vget_low_u32(vhi), vget_high_u32(vhi));
+        uint32x2_t l = vpmin_u32(vget_low_u32(vlo), vget_high_u32(vlo));
+        h = vpmax_u32(h, h);
+        l = vpmin_u32(l, l);
+
+        high   = vget_lane_u32(h, 0);
+        low    = vget_lane_u32(l, 0);
+        sum   += vgetq_lane_s64(vsum, 0) + vgetq_lane_s64(vsum, 1);
+        sumsq += vgetq_lane_s64(vsq,  0) + vgetq_lane_s64(vsq,  1);
+    }
+#elif defined(BMP280_SIMD_SSE41)
+    if (len >= 4)
+    {
+        __m128i vhi  = _mm_set1_epi32((int32_t)high);
+        __m128i vlo  = _mm_set1_epi32((int32_t)low);
+        __m128i vref = _mm_set1_epi32((int32_t)ref);
+        __m128i vsum = _mm_setzero_si128();
+        __m128i vsq  = _mm_setzero_si128();
+
+        for (; i + 4 <= len; i += 4)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+            __m128i d = _mm_sub_epi32(v, vref);
+            vhi  = _mm_max_epu32(vhi, v);
+            vlo  = _mm_min_epu32(vlo, v);
+            vsum = AddWidened(vsum, d);
+            vsq  = AddSquares(vsq, d);
+        }
+
+        vhi = _mm_max_epu32(vhi, _mm_shuffle_epi32(vhi, _MM_SHUFFLE(1,0,3,2)));
+        vhi = _mm_max_epu32(vhi, _mm_shuffle_epi32(vhi, _MM_SHUFFLE(2,3,0,1)));
+        vlo = _mm_min_epu32(vlo, _mm_shuffle_epi32(vlo, _MM_SHUFFLE(1,0,3,2)));
+        vlo = _mm_min_epu32(vlo, _mm_shuffle_epi32(vlo, _MM_SHUFFLE(2,3,0,1)));
+
+        high   = (uint32_t)_mm_cvtsi128_si32(vhi);
+        low    = (uint32_t)_mm_cvtsi128_si32(vlo);
+        sum   += AddLanes(vsum);
+        sumsq += AddLanes(vsq);
+    }
+#endif
+
+    for (; i < len; i++)
+    {
+        uint32_t v = data[i];
+        int32_t  d = (int32_t)(v - ref);
+        if (v > high) high = v;
+        if (v < low)  low  = v;
+        sum   += d;
+        sumsq += (int64_t)d * d;
+    }
+}
+
+
+// Batch Compensation
+// -----------------------------------------------------------------
+
+/*
+ * Cal32Fixed::Press() is split at its division into three passes:
+ *
+ *   PrepareLanes() - temperature, then the pressure numerator and
+ *                    divisor, all in 32-bit lanes.
+ *   DivideLanes()  - the division.
+ *   FinishLanes()  - the correction terms after the division.
+ *
+ * The scalar versions below handle the tail of each pass, and are the
+ * whole kernel when no vector unit is available.
+ */
+
+static inline void Prepare(const Cal32Fixed& c, int32_t ut, uint32_t up,
+                           int32_t& temp, uint32_t& num, uint32_t& den)
+{
+    int32_t tf;
+    temp = c.Temp(ut, tf);
+
+    int32_t v1  = (tf >> 1) - 64000;
+    int32_t v1a = (v1 >> 2)*(v1 >> 2);
+    int32_t v2  = (((v1a >> 11)*c.p6 + v1*c.p5x2) >> 2) + c.p4s16;
+
+    v1 = (((c.p3*(v1a >> 13)) >> 3) + ((c.p2*v1) >> 1)) >> 18;
+    v1 = ((32768 + v1)*c.p1) >> 15;
+
+    num = ((uint32_t)(1048576 - up) - (v2 >> 12)) * 3125;
+    den = (uint32_t)v1;
+}
+
+static inline uint32_t Divide(uint32_t num, uint32_t den)
+{
+    if (den == 0)
+        return 0;
+    return (num < 0x80000000) ? (num << 1)/den : (num/den)*2;
+}
+
+static inline uint32_t Finish(const Cal32Fixed& c, uint32_t v3, uint32_t den)
+{
+    if (den == 0)
+        return 0;
+
+    uint32_t v3a = (v3 >> 3)*(v3 >> 3);
+    int32_t  w1  = (c.p9 * (int32_t)(v3a >> 13)) >> 12;
+    int32_t  w2  = (((int32_t)(v3 >> 2)) * c.p8) >> 13;
+
+    return (uint32_t)( (int32_t)v3 + ((w1 + w2 + c.p7) >> 4) );
+}
+
+/*
+ * PrepareLanes(), vector part. Returns the number of readings done.
+ */
+static size_t PrepareLanes(const Cal32Fixed& c, const int32_t* ut, const uint32_t* up,
+                           int32_t* temp, uint32_t* num, uint32_t* den, size_t len)
+{
+    size_t i = 0;
+
+#if defined(BMP280_SIMD_NEON)
+    int32x4_t t1   = vdupq_n_s32(c.t1),  t1x2 = vdupq_n_s32(c.t1x2);
+    int32x4_t t2   = vdupq_n_s32(c.t2),  t3   = vdupq_n_s32(c.t3);
+    int32x4_t p1   = vdupq_n_s32(c.p1),  p2   = vdupq_n_s32(c.p2);
+    int32x4_t p3   = vdupq_n_s32(c.p3),  p4   = vdupq_n_s32(c.p4s16);
+    int32x4_t p5   = vdupq_n_s32(c.p5x2), p6  = vdupq_n_s32(c.p6);
+
+    for (; i + 4 <= len; i += 4)
+    {
+        int32x4_t u  = vld1q_s32(ut + i);
+        int32x4_t d  = vsubq_s32(vshrq_n_s32(u, 4), t1);
+        int32x4_t a  = vshrq_n_s32(vmulq_s32(vsubq_s32(vshrq_n_s32(u, 3), t1x2), t2), 11);
+        int32x4_t b  = vshrq_n_s32(vmulq_s32(vshrq_n_s32(vmulq_s32(d, d), 12), t3), 14);
+        int32x4_t tf = vaddq_s32(a, b);
+
+        vst1q_s32(temp + i, vshrq_n_s32(vaddq_s32(vmulq_n_s32(tf, 5), vdupq_n_s32(128)), 8));
+
+        int32x4_t v1  = vsubq_s32(vshrq_n_s32(tf, 1), vdupq_n_s32(64000));
+        int32x4_t h   = vshrq_n_s32(v1, 2);
+        int32x4_t v1a = vmulq_s32(h, h);
+        int32x4_t v2  = vaddq_s32(vmulq_s32(vshrq_n_s32(v1a, 11), p6), vmulq_s32(v1, p5));
+        v2 = vaddq_s32(vshrq_n_s32(v2, 2), p4);
+
+        a  = vshrq_n_s32(vmulq_s32(p3, vshrq_n_s32(v1a, 13)), 3);
+        b  = vshrq_n_s32(vmulq_s32(p2, v1), 1);
+        v1 = vshrq_n_s32(vaddq_s32(a, b), 18);
+        v1 = vshrq_n_s32(vmulq_s32(vaddq_s32(v1, vdupq_n_s32(32768)), p1), 15);
+
+        uint32x4_t n = vsubq_u32(vdupq_n_u32(1048576), vld1q_u32(up + i));
+        n = vsubq_u32(n, vreinterpretq_u32_s32(vshrq_n_s32(v2, 12)));
+        vst1q_u32(num + i, vmulq_n_u32(n, 3125));
+        vst1q_u32(den + i, vreinterpretq_u32_s32(v1));
+    }
+#elif defined(BMP280_SIMD_AVX2)
+    __m256i t1   = _mm256_set1_epi32(c.t1),  t1x2 = _mm256_set1_epi32(c.t1x2);
+    __m256i t2   = _mm256_set1_epi32(c.t2),  t3   = _mm256_set1_epi32(c.t3);
+    __m256i p1   = _mm256_set1_epi32(c.p1),  p2   = _mm256_set1_epi32(c.p2);
+    __m256i p3   = _mm256_set1_epi32(c.p3),  p4   = _mm256_set1_epi32(c.p4s16);
+    __m256i p5   = _mm256_set1_epi32(c.p5x2), p6  = _mm256_set1_epi32(c.p6);
+
+    for (; i + 8 <= len; i += 8)
+    {
+        __m256i u  = _mm256_loadu_si256((const __m256i*)(ut + i));
+        __m256i d  = _mm256_sub_epi32(_mm256_srai_epi32(u, 4), t1);
+        __m256i a  = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(_mm256_srai_epi32(u, 3), t1x2), t2), 11);
+        __m256i b  = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(d, d), 12), t3), 14);
+        __m256i tf = _mm256_add_epi32(a, b);
+
+        __m256i t  = _mm256_add_epi32(_mm256_add_epi32(_mm256_slli_epi32(tf, 2), tf), _mm256_set1_epi32(128));
+        _mm256_storeu_si256((__m256i*)(temp + i), _mm256_srai_epi32(t, 8));
+
+        __m256i v1  = _mm256_sub_epi32(_mm256_srai_epi32(tf, 1), _mm256_set1_epi32(64000));
+        __m256i h   = _mm256_srai_epi32(v1, 2);
+        __m256i v1a = _mm256_mullo_epi32(h, h);
+        __m256i v2  = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_srai_epi32(v1a, 11), p6), _mm256_mullo_epi32(v1, p5));
+        v2 = _mm256_add_epi32(_mm256_srai_epi32(v2, 2), p4);
+
+        a  = _mm256_srai_epi32(_mm256_mullo_epi32(p3, _mm256_srai_epi32(v1a, 13)), 3);
+        b  = _mm256_srai_epi32(_mm256_mullo_epi32(p2, v1), 1);
+        v1 = _mm256_srai_epi32(_mm256_add_epi32(a, b), 18);
+        v1 = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_add_epi32(v1, _mm256_set1_epi32(32768)), p1), 15);
+
+        __m256i n = _mm256_sub_epi32(_mm256_set1_epi32(1048576), _mm256_loadu_si256((const __m256i*)(up + i)));
+        n = _mm256_sub_epi32(n, _mm256_srai_epi32(v2, 12));
+        _mm256_storeu_si256((__m256i*)(num + i), _mm256_mullo_epi32(n, _mm256_set1_epi32(3125)));
+        _mm256_storeu_si256((__m256i*)(den + i), v1);
+    }
+#elif defined(BMP280_SIMD_SSE41)
+    __m128i t1   = _mm_set1_epi32(c.t1),  t1x2 = _mm_set1_epi32(c.t1x2);
+    __m128i t2   = _mm_set1_epi32(c.t2),  t3   = _mm_set1_epi32(c.t3);
+    __m128i p1   = _mm_set1_epi32(c.p1),  p2   = _mm_set1_epi32(c.p2);
+    __m128i p3   = _mm_set1_epi32(c.p3),  p4   = _mm_set1_epi32(c.p4s16);
+    __m128i p5   = _mm_set1_epi32(c.p5x2), p6  = _mm_set1_epi32(c.p6);
+
+    for (; i + 4 <= len; i += 4)
+    {
+        __m128i u  = _mm_loadu_si128((const __m128i*)(ut + i));
+        __m128i d  = _mm_sub_epi32(_mm_srai_epi32(u, 4), t1);
+        __m128i a  = _mm_srai_epi32(_mm_mullo_epi32(_mm_sub_epi32(_mm_srai_epi32(u, 3), t1x2), t2), 11);
+        __m128i b  = _mm_srai_epi32(_mm_mullo_epi32(_mm_srai_epi32(_mm_mullo_epi32(d, d), 12), t3), 14);
+        __m128i tf = _mm_add_epi32(a, b);
+
+        __m128i t  = _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(tf, 2), tf), _mm_set1_epi32(128));
+        _mm_storeu_si128((__m128i*)(temp + i), _mm_srai_epi32(t, 8));
+
+        __m128i v1  = _mm_sub_epi32(_mm_srai_epi32(tf, 1), _mm_set1_epi32(64000));
+        __m128i h   = _mm_srai_epi32(v1, 2);
+        __m128i v1a = _mm_mullo_epi32(h, h);
+        __m128i v2  = _mm_add_epi32(_mm_mullo_epi32(_mm_srai_epi32(v1a, 11), p6), _mm_mullo_epi32(v1, p5));
+        v2 = _mm_add_epi32(_mm_srai_epi32(v2, 2), p4);
+
+        a  = _mm_srai_epi32(_mm_mullo_epi32(p3, _mm_srai_epi32(v1a, 13)), 3);
+        b  = _mm_srai_epi32(_mm_mullo_epi32(p2, v1), 1);
+        v1 = _mm_srai_epi32(_mm_add_epi32(a, b), 18);
+        v1 = _mm_srai_epi32(_mm_mullo_epi32(_mm_add_epi32(v1, _mm_set1_epi32(32768)), p1), 15);
+
+        __m128i n = _mm_sub_epi32(_mm_set1_epi32(1048576), _mm_loadu_si128((const __m128i*)(up + i)));
+        n = _mm_sub_epi32(n, _mm_srai_epi32(v2, 12));
+        _mm_storeu_si128((__m128i*)(num + i), _mm_mullo_epi32(n, _mm_set1_epi32(3125)));
+        _mm_storeu_si128((__m128i*)(den + i), v1);
+    }
+#endif
+
+    (void)c; (void)ut; (void)up; (void)temp; (void)num; (void)den; (void)len;
+    return i;
+}
+
+/*
+ * DivideLanes(), vector part. Returns the number of readings done.
+ *
+ * Both operands convert to double exactly, and the correctly rounded
+ * quotient of two integers below 2^32 never rounds across an
+ * integer, so floor() of it is the integer quotient. The quotient is
+ * offset by 2^31 to fit the signed conversion back to 32 bits.
+ * Lanes with a zero divisor produce garbage, and FinishLanes()
+ * zeroes them.
+ */
+static size_t DivideLanes(const uint32_t* num, const uint32_t* den, uint32_t* quot, size_t len)
+{
+    size_t i = 0;
+
+#if defined(BMP280_SIMD_AVX2)
+    const __m128i sign = _mm_set1_epi32((int32_t)0x80000000);
+    const __m256d bias = _mm256_set1_pd(2147483648.0);
+
+    for (; i + 4 <= len; i += 4)
+    {
+        __m128i n     = _mm_loadu_si128((const __m128i*)(num + i));
+        __m128i d     = _mm_loadu_si128((const __m128i*)(den + i));
+        __m128i small = _mm_cmpgt_epi32(n, _mm_set1_epi32(-1));
+        __m128i a     = _mm_blendv_epi8(n, _mm_slli_epi32(n, 1), small);
+
+        __m256d fa = _mm256_add_pd(_mm256_cvtepi32_pd(_mm_xor_si128(a, sign)), bias);
+        __m256d fd = _mm256_add_pd(_mm256_cvtepi32_pd(_mm_xor_si128(d, sign)), bias);
+        __m256d fq = _mm256_sub_pd(_mm256_floor_pd(_mm256_div_pd(fa, fd)), bias);
+
+        __m128i q = _mm_xor_si128(_mm256_cvttpd_epi32(fq), sign);
+        q = _mm_blendv_epi8(_mm_slli_epi32(q, 1), q, small);
+        _mm_storeu_si128((__m128i*)(quot + i), q);
+    }
+#elif defined(BMP280_SIMD_SSE41)
+    const __m128i sign = _mm_set1_epi32((int32_t)0x80000000);
+    const __m128d bias = _mm_set1_pd(2147483648.0);
+
+    for (; i + 2 <= len; i += 2)
+    {
+        __m128i n     = _mm_loadl_epi64((const __m128i*)(num + i));
+        __m128i d     = _mm_loadl_epi64((const __m128i*)(den + i));
+        __m128i small = _mm_cmpgt_epi32(n, _mm_set1_epi32(-1));
+        __m128i a     = _mm_blendv_epi8(n, _mm_slli_epi32(n, 1), small);
+
+        __m128d fa = _mm_add_pd(_mm_cvtepi32_pd(_mm_xor_si128(a, sign)), bias);
+        __m128d fd = _mm_add_pd(_mm_cvtepi32_pd(_mm_xor_si128(d, sign)), bias);
+        __m128d fq = _mm_sub_pd(_mm_floor_pd(_mm_div_pd(fa, fd)), bias);
+
+        __m128i q = _mm_xor_si128(_mm_cvttpd_epi32(fq), sign);
+        q = _mm_blendv_epi8(_mm_slli_epi32(q, 1), q, small);
+        _mm_storel_epi64((__m128i*)(quot + i), q);
+    }
+#endif
+
+    (void)num; (void)den; (void)quot; (void)len;
+    return i;
+}
+
+/*
+ * FinishLanes(), vector part. Returns the number of readings done.
+ */
+static size_t FinishLanes(const Cal32Fixed& c, const uint32_t* quot, const uint32_t* den,
+                          uint32_t* press, size_t len)
+{
+    size_t i = 0;
+
+#if defined(BMP280_SIMD_NEON)
+    int32x4_t p7 = vdupq_n_s32(c.p7), p8 = vdupq_n_s32(c.p8), p9 = vdupq_n_s32(c.p9);
+
+    for (; i + 4 <= len; i += 4)
+    {
+        uint32x4_t v3  = vld1q_u32(quot + i);
+        uint32x4_t s   = vshrq_n_u32(v3, 3);
+        uint32x4_t v3a = vmulq_u32(s, s);
+        int32x4_t  w1  = vshrq_n_s32(vmulq_s32(p9, vreinterpretq_s32_u32(vshrq_n_u32(v3a, 13))), 12);
+        int32x4_t  w2  = vshrq_n_s32(vmulq_s32(vreinterpretq_s32_u32(vshrq_n_u32(v3, 2)), p8), 13);
+        int32x4_t  w   = vshrq_n_s32(vaddq_s32(vaddq_s32(w1, w2), p7), 4);
+        uint32x4_t p   = vaddq_u32(v3, vreinterpretq_u32_s32(w));
+        uint32x4_t z   = vceqq_u32(vld1q_u32(den + i), vdupq_n_u32(0));
+        vst1q_u32(press + i, vbicq_u32(p, z));
+    }
+#elif defined(BMP280_SIMD_AVX2)
+    __m256i p7 = _mm256_set1_epi32(c.p7), p8 = _mm256_set1_epi32(c.p8), p9 = _mm256_set1_epi32(c.p9);
+
+    for (; i + 8 <= len; i += 8)
+    {
+        __m256i v3  = _mm256_loadu_si256((const __m256i*)(quot + i));
+        __m256i s   = _mm256_srli_epi32(v3, 3);
+        __m256i v3a = _mm256_mullo_epi32(s, s);
+        __m256i w1  = _mm256_srai_epi32(_mm256_mullo_epi32(p9, _mm256_srli_epi32(v3a, 13)), 12);
+        __m256i w2  = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(v3, 2), p8), 13);
+        __m256i w   = _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(w1, w2), p7), 4);
+        __m256i z   = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(den + i)), _mm256_setzero_si256());
+        _mm256_storeu_si256((__m256i*)(press + i), _mm256_andnot_si256(z, _mm256_add_epi32(v3, w)));
+    }
+#elif defined(BMP280_SIMD_SSE41)
+    __m128i p7 = _mm_set1_epi32(c.p7), p8 = _mm_set1_epi32(c.p8), p9 = _mm_set1_epi32(c.p9);
+
+    for (; i + 4 <= len; i += 4)
+    {
+        __m128i v3  = _mm_loadu_si128((const __m128i*)(quot + i));
+        __m128i s   = _mm_srli_epi32(v3, 3);
+        __m128i v3a = _mm_mullo_epi32(s, s);
+        __m128i w1  = _mm_srai_epi32(_mm_mullo_epi32(p9, _mm_srli_epi32(v3a, 13)), 12);
+        __m128i w2  = _mm_srai_epi32(_mm_mullo_epi32(_mm_srli_epi32(v3, 2), p8), 13);
+        __m128i w   = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(w1, w2), p7), 4);
+        __m128i z   = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(den + i)), _mm_setzero_si128());
+        _mm_storeu_si128((__m128i*)(press + i), _mm_andnot_si128(z, _mm_add_epi32(v3, w)));
+    }
+#endif
+
+    (void)c; (void)quot; (void)den; (void)press; (void)len;
+    return i;
+}
+
+/*
+ * void Comp32FixedBatch(const Cal32Fixed& cal,
+ *                       const int32_t* unctemp, const uint32_t* uncpress,
+ *                       int32_t* temp, uint32_t* press, size_t len)
+ *
+ * Description:
+ *   Applies 32-bit fixed-point compensation to columns of raw
+ *   temperature and pressure readings, several lanes at a time.
+ *
+ *   Results are identical to Cal32Fixed::Temp() and Cal32Fixed::Press()
+ *   (and so to BMP280::Comp32FixedTemp() and Comp32FixedPress()) for
+ *   every input.
+ *
+ *   Output columns may be the input columns (temp == unctemp,
+ *   press == uncpress), but must not otherwise overlap them.
+ *
+ * Parameters:
+ *   cal      - compiled calibration parameters
+ *   unctemp  - raw temperature readings
+ *   uncpress - raw pressure readings
+ *   temp     - receives temperature, in 1/100 degrees centigrade
+ *   press    - receives pressure, in pascals
+ *   len      - the number of readings
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_simd.hpp
+ */
+void Comp32FixedBatch(const Cal32Fixed& cal,
+                      const int32_t* unctemp, const uint32_t* uncpress,
+                      int32_t* temp, uint32_t* press, size_t len)
+{
+    uint32_t num[BMP280_COMP_CHUNK];
+    uint32_t den[BMP280_COMP_CHUNK];
+    uint32_t quot[BMP280_COMP_CHUNK];
+
+    for (size_t base = 0; base < len; base += BMP280_COMP_CHUNK)
+    {
+        size_t n = len - base;
+        if (n > BMP280_COMP_CHUNK)
+            n = BMP280_COMP_CHUNK;
+
+        const int32_t*  ut = unctemp  + base;
+        const uint32_t* up = uncpress + base;
+        int32_t*        t  = temp     + base;
+        uint32_t*       p  = press    + base;
+        size_t i;
+
+        for (i = PrepareLanes(cal, ut, up, t, num, den, n); i < n; i++)
+            Prepare(cal, ut[i], up[i], t[i], num[i], den[i]);
+
+        for (i = DivideLanes(num, den, quot, n); i < n; i++)
+            quot[i] = Divide(num[i], den[i]);
+
+        for (i = FinishLanes(cal, quot, den, p, n); i < n; i++)
+            p[i] = Finish(cal, quot[i], den[i]);
+    }
+}
+
+} // namespace bosch_bmp280
@@ -0,0 +1,56 @@
+/*
+ * bmp280_simd.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Vectorized kernels for compensating and summarizing columns of
+ *    BMP280 readings.
+ *
+ *  Notes:
+ *    1. NEON is used when compiled with __ARM_NEON (e.g. -mfpu=neon on
+ *       the BeagleBone Black), SSE4.1 when compiled with __SSE4_1__, and
+ *       AVX2 (compensation only) when compiled with __AVX2__.
+ *       Otherwise the kernels fall back to plain loops.
+ *    2. The kernels accumulate into high, low, sum and sumsq, so a column
+ *       that is split across two spans can be summarized with two calls.
+ *    3. Sums are of deviations from a caller-supplied reference value,
+ *       which lets mean and variance come out of the same single pass
+ *       without 64-bit overflow or floating-point cancellation.
+ *    4. Comp32FixedBatch() gives results identical to Cal32Fixed, lane
+ *       for lane, including for out-of-range raw values.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_SIMD_HPP_
+#define BMP280_SIMD_HPP_
+
+#include <cstddef>           // size_t
+#include <stdint.h>          // int32_t, uint32_t, int64_t
+
+#include "bmp280_comp.hpp"   // Cal32Fixed
+
+namespace bosch_bmp280
+{
+
+void  SummarizeI32 ( const  int32_t* data, size_t len,  int32_t ref,
+                      int32_t& high,  int32_t& low, int64_t& sum, int64_t& sumsq );
+void  SummarizeU32 ( const uint32_t* data, size_t len, uint32_t ref,
+                     uint32_t& high, uint32_t& low, int64_t& sum, int64_t& sumsq );
+
+void  Comp32FixedBatch ( const Cal32Fixed& cal,
+                         const int32_t* unctemp, const uint32_t* uncpress,
+                         int32_t* temp, uint32_t* press, size_t len );
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_SIMD_HPP_ */
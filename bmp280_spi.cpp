@@ -0,0 +1,318 @@
+/*
+ * bmp280_spi.cpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Linux spidev implementation of BMP280Bus.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#include <cstdio>                  // snprintf()
+#include <cstring>                 // memcpy(), memset()
+#include <fcntl.h>                 // open()
+#include <linux/spi/spidev.h>      // spi_ioc_transfer, SPI_IOC_*
+#include <stdexcept>               // runtime_error
+#include <sys/ioctl.h>             // ioctl()
+#include <unistd.h>                // close()
+
+#include "bmp280_defs.hpp"         // BMP280_R_CONF, BMP280_SPI3W_MASK
+#include "bmp280_spi.hpp"          // BMP280SPIBus
+
+using namespace std;
+
+namespace bosch_bmp280
+{
+
+// Class Public
+// -----------------------------------------------------------------
+
+/*
+ * BMP280SPIBus::BMP280SPIBus(int bus, uint32_t hz, bool spi3w)
+ *
+ * Description:
+ *   Constructor. Nothing is opened until a chip select is used.
+ *
+ * Parameters:
+ *   bus   - SPI controller number, as in /dev/spidev<bus>.<cs>
+ *   hz    - optional. Clock rate. The default is BMP280_SPI_HZ.
+ *   spi3w - optional. true for 3-wire (shared SDI/SDO). The default
+ *           is 4-wire.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_spi.hpp
+ */
+BMP280SPIBus::BMP280SPIBus(int bus, uint32_t hz, bool spi3w)
+    : busnum(bus), speed(hz), threewire(spi3w)
+{
+    for (int i = 0; i < BMP280_SPI_MAXCS; i++)
+        fds[i] = -1;
+}
+
+/*
+ * BMP280SPIBus::~BMP280SPIBus()
+ *
+ * Description:
+ *   Destructor. Closes any spidev nodes that were opened.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_spi.hpp
+ */
+BMP280SPIBus::~BMP280SPIBus()
+{
+    for (int i = 0; i < BMP280_SPI_MAXCS; i++)
+        if (fds[i] >= 0)
+            close(fds[i]);
+}
+
+/*
+ * void BMP280SPIBus::Read(uint8_t cs, uint8_t reg, uint8_t* data, int len)
+ *
+ * Description:
+ *   Reads len consecutive registers from the device on chip select
+ *   cs, in bursts of up to BMP280_SPI_BURST bytes (one burst for all
+ *   of the driver's own reads).
+ *
+ * Parameters:
+ *   cs   - chip select
+ *   reg  - address of the first register to be read
+ *   data - receives len bytes
+ *   len  - the number of bytes to read
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_spi.hpp
+ */
+void BMP280SPIBus::Read(uint8_t cs, uint8_t reg, uint8_t* data, int len)
+{
+    lock_guard<mutex> lock(busmtx);
+    int fd = this->Open(cs);
+
+    while (len > 0)
+    {
+        int n = (len > BMP280_SPI_BURST) ? BMP280_SPI_BURST : len;
+
+        this->Burst(fd, reg, data, n);
+        reg  += (uint8_t)n;
+        data += n;
+        len  -= n;
+    }
+}
+
+/*
+ * void BMP280SPIBus::Write(uint8_t cs, uint8_t* data, int len)
+ *
+ * Description:
+ *   Writes {register, value} pairs to the device on chip select cs,
+ *   under one chip select assertion. Register addresses have bit 7
+ *   cleared; in 3-wire mode, spi3w_en is kept set in config writes.
+ *
+ * Parameters:
+ *   cs   - chip select
+ *   data - the pairs
+ *   len  - the total number of bytes
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_spi.hpp
+ */
+void BMP280SPIBus::Write(uint8_t cs, uint8_t* data, int len)
+{
+    lock_guard<mutex> lock(busmtx);
+    int fd = this->Open(cs);
+
+    uint8_t tx[BMP280_SPI_BURST * 2];
+    if (len > (int)sizeof(tx))
+    {
+        runtime_error re {"BMP280SPIBus::Write(): Too many register writes."};
+        throw re;
+    }
+
+    for (int i = 0; i + 1 < len; i += 2)
+    {
+        tx[i]     = data[i] & BMP280_SPI_ADDR_MSK;
+        tx[i + 1] = data[i + 1];
+
+        if (threewire && (data[i] | BMP280_SPI_READ) == BMP280_R_CONF)
+            tx[i + 1] |= BMP280_SPI3W_MASK;
+    }
+
+    struct spi_ioc_transfer xfer;
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.tx_buf        = (unsigned long)tx;
+    xfer.len           = (uint32_t)(len & ~1);
+    xfer.speed_hz      = speed;
+    xfer.bits_per_word = 8;
+
+    if (ioctl(fd, SPI_IOC_MESSAGE(1), &xfer) < 0)
+    {
+        runtime_error re {"BMP280SPIBus::Write(): SPI transfer failed."};
+        throw re;
+    }
+}
+
+
+// Class Protected
+// -----------------------------------------------------------------
+
+/*
+ * int BMP280SPIBus::Open(uint8_t cs)
+ *
+ * Description:
+ *   Returns the file descriptor for chip select cs, opening and
+ *   setting up its spidev node the first time. In 3-wire mode, also
+ *   sets the device's spi3w_en bit, which clears the rest of the
+ *   config register.
+ *
+ *   Caller holds busmtx.
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_spi.hpp
+ */
+int BMP280SPIBus::Open(uint8_t cs)
+{
+    if (cs >= BMP280_SPI_MAXCS)
+    {
+        runtime_error re {"BMP280SPIBus::Open(): Chip select out of range."};
+        throw re;
+    }
+
+    if (fds[cs] >= 0)
+        return fds[cs];
+
+    char path[32];
+    snprintf(path, sizeof(path), "/dev/spidev%d.%d", busnum, (int)cs);
+
+    int fd = open(path, O_RDWR);
+    if (fd < 0)
+    {
+        runtime_error re {"BMP280SPIBus::Open(): Cannot open spidev device."};
+        throw re;
+    }
+
+    uint8_t  mode = SPI_MODE_0 | (threewire ? SPI_3WIRE : 0);
+    uint8_t  bits = 8;
+    uint32_t hz   = speed;
+
+    if (ioctl(fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+        ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &hz) < 0)
+    {
+        close(fd);
+        runtime_error re {"BMP280SPIBus::Open(): Cannot configure spidev device."};
+        throw re;
+    }
+
+    if (threewire)
+    {
+        uint8_t tx[] { BMP280_R_CONF & BMP280_SPI_ADDR_MSK, BMP280_SPI3W_MASK };
+
+        struct spi_ioc_transfer xfer;
+        memset(&xfer, 0, sizeof(xfer));
+        xfer.tx_buf        = (unsigned long)tx;
+        xfer.len           = sizeof(tx);
+        xfer.speed_hz      = speed;
+        xfer.bits_per_word = 8;
+
+        if (ioctl(fd, SPI_IOC_MESSAGE(1), &xfer) < 0)
+        {
+            close(fd);
+            runtime_error re {"BMP280SPIBus::Open(): Cannot enable 3-wire mode."};
+            throw re;
+        }
+    }
+
+    fds[cs] = fd;
+    return fd;
+}
+
+/*
+ * void BMP280SPIBus::Burst(int fd, uint8_t reg, uint8_t* data, int len)
+ *
+ * Description:
+ *   One read burst of up to BMP280_SPI_BURST bytes: the control byte,
+ *   then len data bytes, with the chip select held throughout.
+ *
+ *   4-wire: one full-duplex transfer of len + 1 bytes; the first byte
+ *   clocked in is discarded. 3-wire: a one-byte write, then a len-byte
+ *   read, in one message.
+ *
+ * Exceptions:
+ *   runtime_error
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s);
+ *   bmp280_spi.hpp
+ */
+void BMP280SPIBus::Burst(int fd, uint8_t reg, uint8_t* data, int len)
+{
+    uint8_t tx[BMP280_SPI_BURST + 1] {0};
+    uint8_t rx[BMP280_SPI_BURST + 1] {0};
+    struct spi_ioc_transfer xfer[2];
+    int count;
+
+    memset(xfer, 0, sizeof(xfer));
+    tx[0] = reg | BMP280_SPI_READ;
+
+    if (threewire)
+    {
+        xfer[0].tx_buf = (unsigned long)tx;
+        xfer[0].len    = 1;
+        xfer[1].rx_buf = (unsigned long)data;
+        xfer[1].len    = (uint32_t)len;
+        count = 2;
+    }
+    else
+    {
+        xfer[0].tx_buf = (unsigned long)tx;
+        xfer[0].rx_buf = (unsigned long)rx;
+        xfer[0].len    = (uint32_t)len + 1;
+        count = 1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        xfer[i].speed_hz      = speed;
+        xfer[i].bits_per_word = 8;
+    }
+
+    if (ioctl(fd, SPI_IOC_MESSAGE(count), xfer) < 0)
+    {
+        runtime_error re {"BMP280SPIBus::Burst(): SPI transfer failed."};
+        throw re;
+    }
+
+    if (!threewire)
+        memcpy(data, rx + 1, (size_t)len);
+}
+
+} // namespace bosch_bmp280
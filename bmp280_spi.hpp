@@ -0,0 +1,103 @@
+/*
+ * bmp280_spi.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Linux spidev implementation of BMP280Bus, 4-wire or 3-wire.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_SPI_HPP_
+#define BMP280_SPI_HPP_
+
+#include <mutex>             // mutex
+#include <stdint.h>          // uint8_t, uint32_t
+
+#include "bmp280_bus.hpp"    // BMP280Bus
+
+namespace bosch_bmp280
+{
+
+// SPI control byte: bit 7 set to read, clear to write, register
+// address in bits 6..0 (datasheet, section 5.3).
+#define BMP280_SPI_READ      0x80
+#define BMP280_SPI_ADDR_MSK  0x7F
+
+#define BMP280_SPI_HZ        10000000    // device maximum, 10 MHz
+#define BMP280_SPI_MAXCS     8           // chip selects per bus
+#define BMP280_SPI_BURST     32          // largest read per transfer, data bytes
+
+
+/*
+ * class BMP280SPIBus
+ *
+ * Description:
+ *   BMP280Bus over one Linux SPI controller. A device is named by its
+ *   chip select, which takes the place of the I2C address:
+ *
+ *     BMP280SPIBus spi(1);              // /dev/spidev1.*
+ *     BMP280       dev(&spi, 0);        // /dev/spidev1.0
+ *
+ *   Each chip select's spidev node is opened, and set to SPI mode 0,
+ *   8 bits and the requested clock, on first use.
+ *
+ *   Read() is one burst: the control byte and len data bytes, under
+ *   one chip select assertion. In 4-wire mode that is a single
+ *   full-duplex transfer; in 3-wire mode, a write and a read in one
+ *   message. Write() sends all of its {register, value} pairs under
+ *   one assertion too, as the device allows.
+ *
+ *   3-wire mode needs the device's spi3w_en bit. It is written when a
+ *   chip select is opened, and OR'ed into every config register
+ *   write, so configuration set through BMP280 never turns it off. A
+ *   soft reset does turn it off: the device cannot be read until the
+ *   config register is written again, which BMP280::SetConfig() does.
+ *
+ *   Transfers are serialized by a mutex. Errors throw runtime_error.
+ *
+ * Namespace:
+ *   bosch_bmp280
+ *
+ * Header File(s):
+ *   bmp280_spi.hpp
+ */
+class BMP280SPIBus : public BMP280Bus
+{
+  protected:
+    int         busnum;
+    uint32_t    speed;
+    bool        threewire;
+    int         fds[BMP280_SPI_MAXCS];
+    std::mutex  busmtx;
+
+    int   Open  ( uint8_t cs );
+    void  Burst ( int fd, uint8_t reg, uint8_t* data, int len );
+
+  public:
+
+    BMP280SPIBus ( int bus, uint32_t hz=BMP280_SPI_HZ, bool spi3w=false );
+    ~BMP280SPIBus ();
+
+    BMP280SPIBus ( const BMP280SPIBus& ) = delete;
+    BMP280SPIBus& operator= ( const BMP280SPIBus& ) = delete;
+
+    void  Read  ( uint8_t cs, uint8_t reg, uint8_t* data, int len ) override;
+    void  Write ( uint8_t cs, uint8_t* data, int len ) override;
+
+    bool  ThreeWire () const { return threewire; }
+
+}; // class BMP280SPIBus
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_SPI_HPP_ */
@@ -0,0 +1,109 @@
+/*
+ * bmp280_varint.hpp
+ *
+ *  Created on: Oct 14, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Variable-length integer encoding for compact BMP280 records.
+ *
+ *  Notes:
+ *    1. Unsigned values are LEB128: seven bits per byte, low bits
+ *       first, high bit set on every byte but the last.
+ *    2. Signed values (deltas, mostly) are zigzag-mapped first, so
+ *       that small negative numbers are as short as small positive
+ *       ones: 0, -1, 1, -2, 2 ... become 0, 1, 2, 3, 4 ...
+ *    3. Fixed-width fields are little-endian, assembled a byte at a
+ *       time, so they can be read from any alignment.
+ *
+ *  Disclaimer:
+ *    This header was written by JSRagman, who is NOT a professional
+ *    programmer.  Use it, if you like, but don't stake your life on it.
+ *
+ *  And Another Thing:
+ *    JSRagman is not associated in any way with the good people at
+ *    Bosch, although sometimes he is a bit free with the drivers
+ *    that are available on their GitHub site.
+ */
+
+#ifndef BMP280_VARINT_HPP_
+#define BMP280_VARINT_HPP_
+
+#include <stdint.h>          // uint8_t, uint32_t, int64_t, uint64_t
+
+namespace bosch_bmp280
+{
+
+// Longest encoding of a 64-bit value.
+#define BMP280_VARINT_MAX  10
+
+inline uint64_t ZigZag ( int64_t v )
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+inline int64_t UnZigZag ( uint64_t v )
+{
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+// Appends v at p. Returns the position after it.
+inline uint8_t* PutVarint ( uint8_t* p, uint64_t v )
+{
+    while (v >= 0x80)
+    {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// Decodes a value at p, reading no further than end. Returns the
+// position after it, or nullptr if the encoding runs past end.
+inline const uint8_t* GetVarint ( const uint8_t* p, const uint8_t* end, uint64_t& v )
+{
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7)
+    {
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return p;
+    }
+    return nullptr;
+}
+
+inline uint8_t* Put32 ( uint8_t* p, uint32_t v )
+{
+    for (int i = 0; i < 4; i++)
+        *p++ = (uint8_t)(v >> (8*i));
+    return p;
+}
+
+inline uint8_t* Put64 ( uint8_t* p, uint64_t v )
+{
+    for (int i = 0; i < 8; i++)
+        *p++ = (uint8_t)(v >> (8*i));
+    return p;
+}
+
+inline uint32_t Get32 ( const uint8_t* p )
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++)
+        v |= (uint32_t)p[i] << (8*i);
+    return v;
+}
+
+inline uint64_t Get64 ( const uint8_t* p )
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+        v |= (uint64_t)p[i] << (8*i);
+    return v;
+}
+
+} // namespace bosch_bmp280
+
+#endif /* BMP280_VARINT_HPP_ */